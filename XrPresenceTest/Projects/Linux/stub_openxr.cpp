@@ -0,0 +1,679 @@
+/*
+ * Stub OpenXR runtime for the headless benchmark build.
+ *
+ * Implements just the OpenXR surface XrPresenceTest uses, in-process, so the
+ * app's frame loop can run on a machine with no headset or real runtime:
+ * xrWaitFrame paces to a fake display clock, swapchains are plain GL textures
+ * in the app's own EGL context, and session state changes are scripted.
+ *
+ * Environment:
+ *   XRSTUB_REFRESH_HZ       Display rate reported and paced to (default 72)
+ *   XRSTUB_UNPACED=1        Report the period but never block in xrWaitFrame
+ *   XRSTUB_SESSION_SCRIPT   Timed session events after xrCreateSession, e.g.
+ *                           "5:unfocus,6:focus,8:stop,10:ready,15:exit"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+
+#define XR_USE_GRAPHICS_API_OPENGL_ES 1
+#define XR_USE_PLATFORM_EGL 1
+#define XR_USE_TIMESPEC 1
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+
+#define STUB_LOG(...) do { fprintf(stderr, "xrstub: " __VA_ARGS__); fputc('\n', stderr); } while (0)
+
+#define STUB_MAX_EVENTS 32
+#define STUB_MAX_SCRIPT 32
+#define STUB_MAX_PATHS 64
+
+static const char* const STUB_EXTENSIONS[] = {
+    XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME,
+    XR_MNDX_EGL_ENABLE_EXTENSION_NAME,
+    XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME,
+};
+static const uint32_t STUB_EXTENSION_COUNT = sizeof(STUB_EXTENSIONS) / sizeof(STUB_EXTENSIONS[0]);
+
+typedef enum {
+    SCRIPT_UNFOCUS,     // FOCUSED -> VISIBLE, like a system panel taking focus
+    SCRIPT_FOCUS,       // VISIBLE -> FOCUSED
+    SCRIPT_STOP,        // -> STOPPING, IDLE once the app ends the session
+    SCRIPT_READY,       // IDLE -> READY
+    SCRIPT_EXIT,        // -> STOPPING, then IDLE and EXITING
+} ovrStubScriptOp;
+
+typedef struct {
+    uint64_t AtNs;      // Relative to session creation
+    ovrStubScriptOp Op;
+    bool Done;
+} ovrStubScriptEntry;
+
+struct XrInstance_T { int Unused; };
+struct XrActionSet_T { int Unused; };
+struct XrAction_T { XrActionType Type; };
+
+struct XrSession_T {
+    XrSessionState State;
+    bool Running;           // Between xrBeginSession and xrEndSession
+    bool ExitRequested;
+    uint64_t CreateNs;
+
+    XrDuration Period;
+    bool Paced;
+    XrTime NextVsync;
+    int64_t FramesBegun;
+    int64_t FramesEnded;
+    uint64_t LayersSubmitted;
+    uint32_t MaxLayers;
+
+    ovrStubScriptEntry Script[STUB_MAX_SCRIPT];
+    int ScriptCount;
+};
+
+struct XrSpace_T {
+    bool IsAction;
+};
+
+struct XrSwapchain_T {
+    GLuint* Textures;
+    uint32_t ImageCount;
+    uint32_t Width;
+    uint32_t Height;
+    bool IsStatic;
+    uint32_t NextIndex;
+    int Acquired;           // Acquired but not yet released
+    uint32_t TotalAcquires;
+};
+
+static struct {
+    pthread_mutex_t Lock;   // Event queue and session state
+    XrInstance Instance;
+    XrSession Session;
+    XrEventDataSessionStateChanged Events[STUB_MAX_EVENTS];
+    int EventHead;
+    int EventCount;
+    char Paths[STUB_MAX_PATHS][XR_MAX_PATH_LENGTH];
+    int PathCount;
+    uint32_t SwapchainsCreated;
+    uint32_t StaticSwapchainsCreated;
+} g_Stub = {PTHREAD_MUTEX_INITIALIZER};
+
+// XrTime is CLOCK_MONOTONIC in nanoseconds, so timespec conversion is exact.
+static XrTime StubNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (XrTime)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int GetEnvInt(const char* name, int defaultValue) {
+    const char* value = getenv(name);
+    return (value && value[0]) ? atoi(value) : defaultValue;
+}
+
+// Caller holds g_Stub.Lock.
+static void QueueStateLocked(XrSession session, XrSessionState state) {
+    if (g_Stub.EventCount == STUB_MAX_EVENTS) {
+        STUB_LOG("event queue full, dropping state %d", (int)state);
+        return;
+    }
+    XrEventDataSessionStateChanged* event =
+        &g_Stub.Events[(g_Stub.EventHead + g_Stub.EventCount) % STUB_MAX_EVENTS];
+    memset(event, 0, sizeof(*event));
+    event->type = XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED;
+    event->session = session;
+    event->state = state;
+    event->time = StubNow();
+    g_Stub.EventCount++;
+    session->State = state;
+}
+
+// Walks a running session down to STOPPING. Caller holds g_Stub.Lock.
+static void StopSessionLocked(XrSession session) {
+    if (session->State == XR_SESSION_STATE_FOCUSED) {
+        QueueStateLocked(session, XR_SESSION_STATE_VISIBLE);
+    }
+    if (session->State == XR_SESSION_STATE_VISIBLE) {
+        QueueStateLocked(session, XR_SESSION_STATE_SYNCHRONIZED);
+    }
+    if (session->State == XR_SESSION_STATE_SYNCHRONIZED) {
+        QueueStateLocked(session, XR_SESSION_STATE_STOPPING);
+    }
+}
+
+static void ParseSessionScript(XrSession session) {
+    const char* script = getenv("XRSTUB_SESSION_SCRIPT");
+    if (!script) return;
+
+    static const struct { const char* Name; ovrStubScriptOp Op; } OPS[] = {
+        {"unfocus", SCRIPT_UNFOCUS}, {"focus", SCRIPT_FOCUS}, {"stop", SCRIPT_STOP},
+        {"ready", SCRIPT_READY}, {"exit", SCRIPT_EXIT},
+    };
+
+    const char* p = script;
+    while (*p && session->ScriptCount < STUB_MAX_SCRIPT) {
+        char* end = NULL;
+        double seconds = strtod(p, &end);
+        if (end == p || *end != ':') {
+            STUB_LOG("bad XRSTUB_SESSION_SCRIPT near \"%s\"", p);
+            return;
+        }
+        p = end + 1;
+        size_t len = strcspn(p, ",");
+        bool found = false;
+        for (size_t i = 0; i < sizeof(OPS) / sizeof(OPS[0]); i++) {
+            if (strlen(OPS[i].Name) == len && strncmp(OPS[i].Name, p, len) == 0) {
+                ovrStubScriptEntry* entry = &session->Script[session->ScriptCount++];
+                entry->AtNs = (uint64_t)(seconds * 1e9);
+                entry->Op = OPS[i].Op;
+                found = true;
+            }
+        }
+        if (!found) {
+            STUB_LOG("unknown session script event \"%.*s\"", (int)len, p);
+        }
+        p += len;
+        if (*p == ',') p++;
+    }
+}
+
+// Applies script entries that are due. Caller holds g_Stub.Lock.
+static void RunSessionScriptLocked(XrSession session) {
+    uint64_t elapsed = (uint64_t)(StubNow() - (XrTime)session->CreateNs);
+    for (int i = 0; i < session->ScriptCount; i++) {
+        ovrStubScriptEntry* entry = &session->Script[i];
+        if (entry->Done || entry->AtNs > elapsed) continue;
+        entry->Done = true;
+
+        switch (entry->Op) {
+            case SCRIPT_UNFOCUS:
+                if (session->State == XR_SESSION_STATE_FOCUSED) {
+                    QueueStateLocked(session, XR_SESSION_STATE_VISIBLE);
+                }
+                break;
+            case SCRIPT_FOCUS:
+                if (session->State == XR_SESSION_STATE_VISIBLE) {
+                    QueueStateLocked(session, XR_SESSION_STATE_FOCUSED);
+                }
+                break;
+            case SCRIPT_STOP:
+                StopSessionLocked(session);
+                break;
+            case SCRIPT_READY:
+                if (session->State == XR_SESSION_STATE_IDLE) {
+                    QueueStateLocked(session, XR_SESSION_STATE_READY);
+                }
+                break;
+            case SCRIPT_EXIT:
+                session->ExitRequested = true;
+                if (session->Running) {
+                    StopSessionLocked(session);
+                } else {
+                    QueueStateLocked(session, XR_SESSION_STATE_EXITING);
+                }
+                break;
+        }
+    }
+}
+
+// ================================================================================
+// Instance
+// ================================================================================
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateInstanceExtensionProperties(
+        const char* layerName, uint32_t propertyCapacityInput, uint32_t* propertyCountOutput,
+        XrExtensionProperties* properties) {
+    *propertyCountOutput = STUB_EXTENSION_COUNT;
+    if (propertyCapacityInput == 0) return XR_SUCCESS;
+    if (propertyCapacityInput < STUB_EXTENSION_COUNT) return XR_ERROR_SIZE_INSUFFICIENT;
+    for (uint32_t i = 0; i < STUB_EXTENSION_COUNT; i++) {
+        snprintf(properties[i].extensionName, XR_MAX_EXTENSION_NAME_SIZE, "%s", STUB_EXTENSIONS[i]);
+        properties[i].extensionVersion = 1;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* instance) {
+    for (uint32_t i = 0; i < createInfo->enabledExtensionCount; i++) {
+        bool known = false;
+        for (uint32_t j = 0; j < STUB_EXTENSION_COUNT; j++) {
+            known = known || strcmp(createInfo->enabledExtensionNames[i], STUB_EXTENSIONS[j]) == 0;
+        }
+        if (!known) {
+            STUB_LOG("extension not present: %s", createInfo->enabledExtensionNames[i]);
+            return XR_ERROR_EXTENSION_NOT_PRESENT;
+        }
+    }
+    if (g_Stub.Instance) return XR_ERROR_LIMIT_REACHED;
+    g_Stub.Instance = (XrInstance)calloc(1, sizeof(XrInstance_T));
+    *instance = g_Stub.Instance;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyInstance(XrInstance instance) {
+    STUB_LOG("%u swapchains created (%u static)", g_Stub.SwapchainsCreated, g_Stub.StaticSwapchainsCreated);
+    free(instance);
+    g_Stub.Instance = XR_NULL_HANDLE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrResultToString(XrInstance instance, XrResult value,
+                                                char buffer[XR_MAX_RESULT_STRING_SIZE]) {
+    const char* name = NULL;
+    switch (value) {
+        case XR_SUCCESS: name = "XR_SUCCESS"; break;
+        case XR_EVENT_UNAVAILABLE: name = "XR_EVENT_UNAVAILABLE"; break;
+        case XR_FRAME_DISCARDED: name = "XR_FRAME_DISCARDED"; break;
+        case XR_ERROR_VALIDATION_FAILURE: name = "XR_ERROR_VALIDATION_FAILURE"; break;
+        case XR_ERROR_HANDLE_INVALID: name = "XR_ERROR_HANDLE_INVALID"; break;
+        case XR_ERROR_CALL_ORDER_INVALID: name = "XR_ERROR_CALL_ORDER_INVALID"; break;
+        case XR_ERROR_SESSION_NOT_RUNNING: name = "XR_ERROR_SESSION_NOT_RUNNING"; break;
+        case XR_ERROR_SESSION_NOT_READY: name = "XR_ERROR_SESSION_NOT_READY"; break;
+        case XR_ERROR_SESSION_NOT_STOPPING: name = "XR_ERROR_SESSION_NOT_STOPPING"; break;
+        case XR_ERROR_LIMIT_REACHED: name = "XR_ERROR_LIMIT_REACHED"; break;
+        case XR_ERROR_EXTENSION_NOT_PRESENT: name = "XR_ERROR_EXTENSION_NOT_PRESENT"; break;
+        case XR_ERROR_FUNCTION_UNSUPPORTED: name = "XR_ERROR_FUNCTION_UNSUPPORTED"; break;
+        default: break;
+    }
+    if (name) {
+        snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "%s", name);
+    } else {
+        snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "XR_UNKNOWN_RESULT_%d", (int)value);
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetSystem(XrInstance instance, const XrSystemGetInfo* getInfo,
+                                           XrSystemId* systemId) {
+    *systemId = 1;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL StubGetOpenGLESGraphicsRequirements(
+        XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsOpenGLESKHR* requirements) {
+    requirements->minApiVersionSupported = XR_MAKE_VERSION(3, 0, 0);
+    requirements->maxApiVersionSupported = XR_MAKE_VERSION(3, 2, 0);
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL StubConvertTimeToTimespecTime(XrInstance instance, XrTime time,
+                                                          struct timespec* timespecTime) {
+    timespecTime->tv_sec = time / 1000000000LL;
+    timespecTime->tv_nsec = time % 1000000000LL;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL StubConvertTimespecTimeToTime(XrInstance instance,
+                                                          const struct timespec* timespecTime, XrTime* time) {
+    *time = (XrTime)timespecTime->tv_sec * 1000000000LL + timespecTime->tv_nsec;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProcAddr(XrInstance instance, const char* name,
+                                                     PFN_xrVoidFunction* function) {
+    *function = NULL;
+    if (strcmp(name, "xrGetOpenGLESGraphicsRequirementsKHR") == 0) {
+        *function = (PFN_xrVoidFunction)StubGetOpenGLESGraphicsRequirements;
+    } else if (strcmp(name, "xrConvertTimeToTimespecTimeKHR") == 0) {
+        *function = (PFN_xrVoidFunction)StubConvertTimeToTimespecTime;
+    } else if (strcmp(name, "xrConvertTimespecTimeToTimeKHR") == 0) {
+        *function = (PFN_xrVoidFunction)StubConvertTimespecTimeToTime;
+    }
+    return *function ? XR_SUCCESS : XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrPollEvent(XrInstance instance, XrEventDataBuffer* eventData) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    if (g_Stub.Session) {
+        RunSessionScriptLocked(g_Stub.Session);
+    }
+    XrResult result = XR_EVENT_UNAVAILABLE;
+    if (g_Stub.EventCount > 0) {
+        memcpy(eventData, &g_Stub.Events[g_Stub.EventHead], sizeof(XrEventDataSessionStateChanged));
+        g_Stub.EventHead = (g_Stub.EventHead + 1) % STUB_MAX_EVENTS;
+        g_Stub.EventCount--;
+        result = XR_SUCCESS;
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrStringToPath(XrInstance instance, const char* pathString, XrPath* path) {
+    for (int i = 0; i < g_Stub.PathCount; i++) {
+        if (strcmp(g_Stub.Paths[i], pathString) == 0) {
+            *path = (XrPath)(i + 1);
+            return XR_SUCCESS;
+        }
+    }
+    if (g_Stub.PathCount == STUB_MAX_PATHS) return XR_ERROR_PATH_COUNT_EXCEEDED;
+    snprintf(g_Stub.Paths[g_Stub.PathCount], XR_MAX_PATH_LENGTH, "%s", pathString);
+    *path = (XrPath)++g_Stub.PathCount;
+    return XR_SUCCESS;
+}
+
+// ================================================================================
+// Session
+// ================================================================================
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateSession(XrInstance instance, const XrSessionCreateInfo* createInfo,
+                                               XrSession* session) {
+    const XrGraphicsBindingEGLMNDX* binding = (const XrGraphicsBindingEGLMNDX*)createInfo->next;
+    if (!binding || binding->type != XR_TYPE_GRAPHICS_BINDING_EGL_MNDX || !binding->context) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+    if (g_Stub.Session) return XR_ERROR_LIMIT_REACHED;
+
+    XrSession s = (XrSession)calloc(1, sizeof(XrSession_T));
+    s->CreateNs = (uint64_t)StubNow();
+    int hz = GetEnvInt("XRSTUB_REFRESH_HZ", 72);
+    s->Period = 1000000000LL / (hz > 0 ? hz : 72);
+    s->Paced = GetEnvInt("XRSTUB_UNPACED", 0) == 0;
+    ParseSessionScript(s);
+    STUB_LOG("session at %d Hz%s, %d script events", hz, s->Paced ? "" : " (unpaced)", s->ScriptCount);
+
+    pthread_mutex_lock(&g_Stub.Lock);
+    g_Stub.Session = s;
+    QueueStateLocked(s, XR_SESSION_STATE_IDLE);
+    QueueStateLocked(s, XR_SESSION_STATE_READY);
+    pthread_mutex_unlock(&g_Stub.Lock);
+
+    *session = s;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySession(XrSession session) {
+    STUB_LOG("%lld frames, %.2f layers/frame (max %u)", (long long)session->FramesEnded,
+             session->FramesEnded ? (double)session->LayersSubmitted / session->FramesEnded : 0.0,
+             session->MaxLayers);
+    pthread_mutex_lock(&g_Stub.Lock);
+    g_Stub.Session = XR_NULL_HANDLE;
+    g_Stub.EventCount = 0;
+    pthread_mutex_unlock(&g_Stub.Lock);
+    free(session);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrBeginSession(XrSession session, const XrSessionBeginInfo* beginInfo) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    XrResult result = XR_SUCCESS;
+    if (session->Running) {
+        result = XR_ERROR_SESSION_RUNNING;
+    } else if (session->State != XR_SESSION_STATE_READY) {
+        result = XR_ERROR_SESSION_NOT_READY;
+    } else {
+        session->Running = true;
+        session->NextVsync = 0;
+        QueueStateLocked(session, XR_SESSION_STATE_SYNCHRONIZED);
+        QueueStateLocked(session, XR_SESSION_STATE_VISIBLE);
+        QueueStateLocked(session, XR_SESSION_STATE_FOCUSED);
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEndSession(XrSession session) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    XrResult result = XR_SUCCESS;
+    if (session->State != XR_SESSION_STATE_STOPPING) {
+        result = XR_ERROR_SESSION_NOT_STOPPING;
+    } else {
+        session->Running = false;
+        QueueStateLocked(session, XR_SESSION_STATE_IDLE);
+        if (session->ExitRequested) {
+            QueueStateLocked(session, XR_SESSION_STATE_EXITING);
+        }
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrRequestExitSession(XrSession session) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    XrResult result = XR_SUCCESS;
+    if (!session->Running) {
+        result = XR_ERROR_SESSION_NOT_RUNNING;
+    } else {
+        session->ExitRequested = true;
+        StopSessionLocked(session);
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return result;
+}
+
+// Blocks until the next fake vsync and predicts display one period later, the
+// way a compositor running one frame ahead would.
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo,
+                                           XrFrameState* frameState) {
+    if (!session->Running) return XR_ERROR_SESSION_NOT_RUNNING;
+
+    XrTime now = StubNow();
+    XrDuration period = session->Period;
+    if (!session->Paced) {
+        session->NextVsync = now;   // Every call is a vsync
+    } else if (session->NextVsync == 0) {
+        session->NextVsync = now + period;
+    } else if (now > session->NextVsync) {
+        // Missed vsyncs are skipped, not queued up
+        session->NextVsync += ((now - session->NextVsync) / period + 1) * period;
+    }
+    if (session->Paced) {
+        struct timespec wake;
+        wake.tv_sec = session->NextVsync / 1000000000LL;
+        wake.tv_nsec = session->NextVsync % 1000000000LL;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0) {
+        }
+    }
+
+    pthread_mutex_lock(&g_Stub.Lock);
+    XrSessionState state = session->State;
+    pthread_mutex_unlock(&g_Stub.Lock);
+
+    frameState->predictedDisplayTime = session->NextVsync + period;
+    frameState->predictedDisplayPeriod = period;
+    frameState->shouldRender = (state == XR_SESSION_STATE_VISIBLE || state == XR_SESSION_STATE_FOCUSED);
+    session->NextVsync += period;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo) {
+    if (!session->Running) return XR_ERROR_SESSION_NOT_RUNNING;
+    // A second begin without an end discards the earlier frame
+    bool discarded = __atomic_load_n(&session->FramesBegun, __ATOMIC_RELAXED) >
+                     __atomic_load_n(&session->FramesEnded, __ATOMIC_RELAXED);
+    if (discarded) {
+        __atomic_store_n(&session->FramesEnded, session->FramesBegun, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&session->FramesBegun, 1, __ATOMIC_RELAXED);
+    return discarded ? XR_FRAME_DISCARDED : XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo) {
+    if (!session->Running) return XR_ERROR_SESSION_NOT_RUNNING;
+    if (session->FramesEnded >= session->FramesBegun) return XR_ERROR_CALL_ORDER_INVALID;
+
+    for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+        const XrCompositionLayerBaseHeader* layer = frameEndInfo->layers[i];
+        if (layer->type != XR_TYPE_COMPOSITION_LAYER_QUAD) continue;
+        const XrCompositionLayerQuad* quad = (const XrCompositionLayerQuad*)layer;
+        if (!quad->subImage.swapchain || quad->subImage.swapchain->TotalAcquires == 0) {
+            return XR_ERROR_LAYER_INVALID;
+        }
+    }
+
+    session->LayersSubmitted += frameEndInfo->layerCount;
+    if (frameEndInfo->layerCount > session->MaxLayers) {
+        session->MaxLayers = frameEndInfo->layerCount;
+    }
+    __atomic_add_fetch(&session->FramesEnded, 1, __ATOMIC_RELAXED);
+    return XR_SUCCESS;
+}
+
+// ================================================================================
+// Spaces and actions. Reference spaces sit at the origin; action spaces are
+// never tracked and the trigger reads zero, so input comes from the app's
+// scripted aim pose (XRPRESENCE_SCRIPTED_POSE=1).
+// ================================================================================
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo* createInfo,
+                                                      XrSpace* space) {
+    *space = (XrSpace)calloc(1, sizeof(XrSpace_T));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo,
+                                                   XrSpace* space) {
+    *space = (XrSpace)calloc(1, sizeof(XrSpace_T));
+    (*space)->IsAction = true;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySpace(XrSpace space) {
+    free(space);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time,
+                                             XrSpaceLocation* location) {
+    memset(&location->pose, 0, sizeof(location->pose));
+    location->pose.orientation.w = 1.0f;
+    location->locationFlags = space->IsAction ? 0 :
+        (XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+         XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo* createInfo,
+                                                 XrActionSet* actionSet) {
+    *actionSet = (XrActionSet)calloc(1, sizeof(XrActionSet_T));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyActionSet(XrActionSet actionSet) {
+    free(actionSet);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo,
+                                              XrAction* action) {
+    *action = (XrAction)calloc(1, sizeof(XrAction_T));
+    (*action)->Type = createInfo->actionType;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyAction(XrAction action) {
+    free(action);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrSuggestInteractionProfileBindings(
+        XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings) {
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAttachSessionActionSets(XrSession session,
+                                                         const XrSessionActionSetsAttachInfo* attachInfo) {
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    bool focused = session->State == XR_SESSION_STATE_FOCUSED;
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return focused ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo,
+                                                     XrActionStateFloat* state) {
+    state->currentState = 0.0f;
+    state->changedSinceLastSync = XR_FALSE;
+    state->lastChangeTime = 0;
+    state->isActive = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+// ================================================================================
+// Swapchains: GL textures created in the app's context (a real runtime would
+// share them from its own).
+// ================================================================================
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo* createInfo,
+                                                 XrSwapchain* swapchain) {
+    if (createInfo->width == 0 || createInfo->height == 0) return XR_ERROR_SWAPCHAIN_RECT_INVALID;
+
+    XrSwapchain sc = (XrSwapchain)calloc(1, sizeof(XrSwapchain_T));
+    sc->IsStatic = (createInfo->createFlags & XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) != 0;
+    sc->ImageCount = sc->IsStatic ? 1 : 3;
+    sc->Width = createInfo->width;
+    sc->Height = createInfo->height;
+    sc->Textures = (GLuint*)calloc(sc->ImageCount, sizeof(GLuint));
+
+    glGenTextures(sc->ImageCount, sc->Textures);
+    for (uint32_t i = 0; i < sc->ImageCount; i++) {
+        glBindTexture(GL_TEXTURE_2D, sc->Textures[i]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, (GLenum)createInfo->format, sc->Width, sc->Height);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (glGetError() != GL_NO_ERROR) {
+        STUB_LOG("swapchain format 0x%llx rejected", (unsigned long long)createInfo->format);
+        glDeleteTextures(sc->ImageCount, sc->Textures);
+        free(sc->Textures);
+        free(sc);
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+
+    __atomic_add_fetch(&g_Stub.SwapchainsCreated, 1, __ATOMIC_RELAXED);
+    if (sc->IsStatic) {
+        __atomic_add_fetch(&g_Stub.StaticSwapchainsCreated, 1, __ATOMIC_RELAXED);
+    }
+    *swapchain = sc;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySwapchain(XrSwapchain swapchain) {
+    glDeleteTextures(swapchain->ImageCount, swapchain->Textures);
+    free(swapchain->Textures);
+    free(swapchain);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput,
+                                                          uint32_t* imageCountOutput,
+                                                          XrSwapchainImageBaseHeader* images) {
+    *imageCountOutput = swapchain->ImageCount;
+    if (imageCapacityInput == 0) return XR_SUCCESS;
+    if (imageCapacityInput < swapchain->ImageCount) return XR_ERROR_SIZE_INSUFFICIENT;
+    XrSwapchainImageOpenGLESKHR* glImages = (XrSwapchainImageOpenGLESKHR*)images;
+    for (uint32_t i = 0; i < swapchain->ImageCount; i++) {
+        glImages[i].image = swapchain->Textures[i];
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAcquireSwapchainImage(XrSwapchain swapchain,
+                                                       const XrSwapchainImageAcquireInfo* acquireInfo,
+                                                       uint32_t* index) {
+    // Static swapchains may only ever be acquired once
+    if (swapchain->Acquired >= (int)swapchain->ImageCount ||
+        (swapchain->IsStatic && swapchain->TotalAcquires > 0)) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    *index = swapchain->NextIndex;
+    swapchain->NextIndex = (swapchain->NextIndex + 1) % swapchain->ImageCount;
+    swapchain->Acquired++;
+    swapchain->TotalAcquires++;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitSwapchainImage(XrSwapchain swapchain,
+                                                    const XrSwapchainImageWaitInfo* waitInfo) {
+    return swapchain->Acquired > 0 ? XR_SUCCESS : XR_ERROR_CALL_ORDER_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrReleaseSwapchainImage(XrSwapchain swapchain,
+                                                       const XrSwapchainImageReleaseInfo* releaseInfo) {
+    if (swapchain->Acquired == 0) return XR_ERROR_CALL_ORDER_INVALID;
+    swapchain->Acquired--;
+    return XR_SUCCESS;
+}
@@ -0,0 +1,977 @@
+/*
+ * Stub libovrplatformloader for the headless benchmark build.
+ *
+ * Implements the Platform SDK entry points XrPresenceTest calls. Each request
+ * is answered after a latency drawn from a configurable distribution, fails at
+ * a configurable per-API rate, and extra messages can be scripted or generated
+ * as floods to measure message throughput. The stub also models the server's
+ * presence: an invite panel launched while the user is not joinable closes
+ * right away (the docs/problem.md bug), one launched while joinable stays
+ * open for OVRSTUB_PANEL_MS. Invitable users come from a generated friends
+ * list, served in pages, and SendInvites is held to a request quota. Random
+ * draws are seeded, so runs repeat.
+ *
+ * Environment:
+ *   OVRSTUB_LATENCY_MS   Fixed response latency (default 50)
+ *   OVRSTUB_LATENCY      Latency distributions, ';'-separated, optionally per API:
+ *                            fixed:<ms>  uniform:<min>,<max>  normal:<mean>,<stddev>
+ *                            lognormal:<median>,<sigma>  exp:<mean>
+ *                        e.g. "lognormal:60,0.5;GroupPresence_Set=uniform:100,900"
+ *   OVRSTUB_ERRORS       Error rates, e.g. "GroupPresence_Set=0.2;*=0.01"
+ *   OVRSTUB_FLOOD        Notification floods, ';'-separated:
+ *                            <type>:<per_second>[:<burst>[:<start_ms>[:<duration_ms>]]]
+ *                        <burst> messages arrive together (default 1). e.g.
+ *                        "Notification_GroupPresence_JoinIntentReceived:2000:100"
+ *   OVRSTUB_PANEL_MS     How long a working invite panel stays open (default 0)
+ *   OVRSTUB_FRIENDS      Invitable users (default 100)
+ *   OVRSTUB_FRIENDS_PAGE Users per GetInvitableUsers / GetNextUserArrayPage page
+ *                        (default 50)
+ *   OVRSTUB_INVITE_QUOTA SendInvites requests allowed, <per_second>[:<burst>]
+ *                        (default unlimited). Requests over it fail.
+ *   OVRSTUB_SEED         Random seed (default 1)
+ *   OVRSTUB_REPLAY       Recording from the app's record_platform knob to play back.
+ *                        Notifications arrive at their recorded times; recorded
+ *                        responses answer the app's requests of the same type in
+ *                        issue order, at their recorded time or right away (in
+ *                        recorded order) if the request comes later. Requests
+ *                        beyond the recording are answered as usual. Replayed
+ *                        user pages hold the stub's own friends list.
+ *   OVRSTUB_REPLAY_SPEED Playback speed (default 1, 0 = everything at once)
+ *   OVRSTUB_SCRIPT       File of timed messages, one per line, relative to init:
+ *                            <at_ms> <type> [count] [!error message]
+ *                        <type> is a name from MESSAGE_NAMES below or a hex
+ *                        ovrMessageType. Example:
+ *                            # 5000 unsolicited notifications at t=2s
+ *                            2000 Notification_GroupPresence_JoinIntentReceived 5000
+ *                            3000 GroupPresence_Set 1 !Presence rejected
+ *
+ * A summary of requests, injected errors and flood messages goes to stderr at exit.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <queue>
+#include <vector>
+
+#include <OVR_Platform.h>
+
+#include "xr_recording_format.h"
+
+#define STUB_LOG(...) do { fprintf(stderr, "ovrstub: " __VA_ARGS__); fputc('\n', stderr); } while (0)
+
+struct ovrError {
+    int Code;
+    char Message[256];
+};
+
+// Payloads. Strings point at the defaults below or at the message's Text.
+struct ovrGroupPresenceJoinIntent {
+    const char* DeeplinkMessage;
+    const char* DestinationApiName;
+    const char* LobbySessionId;
+    const char* MatchSessionId;
+};
+
+struct ovrGroupPresenceLeaveIntent {
+    const char* DestinationApiName;
+    const char* LobbySessionId;
+    const char* MatchSessionId;
+};
+
+struct ovrUser {
+    ovrID Id;
+    char DisplayName[32];
+    char OculusId[32];
+};
+
+// A page of the friends list, or just a count for the invitations sent
+struct ovrUserArray {
+    size_t Size;
+    const ovrUser* Users;   // NULL when only Size is known
+    size_t Offset;          // Of Users[0] in the friends list
+    bool HasNextPage;
+};
+
+struct ovrLaunchInvitePanelFlowResult {
+    ovrUserArray InvitedUsers;
+};
+
+struct ovrInvitePanelResultInfo {
+    bool InvitesSent;
+};
+
+struct ovrApplicationInviteArray {
+    size_t Size;
+};
+
+struct ovrSendInvitesResult {
+    ovrApplicationInviteArray Invites;
+};
+
+struct ovrMessage {
+    ovrMessageType Type;
+    ovrRequest RequestId;
+    uint64_t DueNs;
+    uint64_t Sequence;      // FIFO order among messages due at the same time
+    bool IsError;
+    ovrError Error;
+    ovrGroupPresenceJoinIntent JoinIntent;
+    ovrGroupPresenceLeaveIntent LeaveIntent;
+    ovrLaunchInvitePanelFlowResult InvitePanelFlowResult;
+    ovrInvitePanelResultInfo InvitePanelResult;
+    ovrUserArray Users;
+    ovrSendInvitesResult SendInvitesResult;
+    char* Text;             // Replayed payload strings, owned
+};
+
+struct ovrGroupPresenceOptions {
+    char DestinationApiName[128];
+    char LobbySessionId[128];
+    char MatchSessionId[128];
+    bool IsJoinable;
+};
+
+struct ovrInviteOptions {
+    int Unused;
+};
+
+static const ovrGroupPresenceJoinIntent DEFAULT_JOIN_INTENT = {"", "test-location", "stub_lobby", ""};
+static const ovrGroupPresenceLeaveIntent DEFAULT_LEAVE_INTENT = {"test-location", "stub_lobby", ""};
+
+// Every type the SDK defines, from the app's generated list. Latencies and
+// error rates are kept per entry.
+static const struct {
+    const char* Name;
+    ovrMessageType Type;
+} MESSAGE_NAMES[] = {
+#define OVR_MESSAGE(name, payload) {#name, ovrMessage_##name},
+#include "ovr_message_types.h"
+#undef OVR_MESSAGE
+};
+#define MESSAGE_NAME_COUNT (int)(sizeof(MESSAGE_NAMES) / sizeof(MESSAGE_NAMES[0]))
+
+enum LatencyKind { LATENCY_FIXED, LATENCY_UNIFORM, LATENCY_NORMAL, LATENCY_LOGNORMAL, LATENCY_EXP };
+
+struct LatencySpec {
+    LatencyKind Kind;
+    double A, B;            // Milliseconds, except the lognormal sigma
+};
+
+struct Flood {
+    ovrMessageType Type;
+    uint32_t Burst;
+    uint64_t IntervalNs;    // Between bursts
+    uint64_t NextNs;
+    uint64_t EndNs;         // 0 = until exit
+};
+
+// A Set or Clear; the server has applied it once its response is due
+struct PresenceChange {
+    uint64_t DueNs;
+    ovrRequest Request;     // Issue order: the newest applied change wins
+    bool Joinable;
+};
+
+#define MAX_FLOODS 8
+
+struct MessageLater {
+    bool operator()(const ovrMessage* a, const ovrMessage* b) const {
+        return a->DueNs != b->DueNs ? a->DueNs > b->DueNs : a->Sequence > b->Sequence;
+    }
+};
+
+static struct {
+    pthread_mutex_t Lock;
+    std::priority_queue<ovrMessage*, std::vector<ovrMessage*>, MessageLater>* Queue;
+    uint64_t NextSequence;
+    ovrRequest NextRequest;
+    uint64_t Random;
+    LatencySpec Latency[MESSAGE_NAME_COUNT];
+    double ErrorRate[MESSAGE_NAME_COUNT];
+    Flood Floods[MAX_FLOODS];
+    int FloodCount;
+    uint64_t PanelNs;
+    std::vector<PresenceChange>* PresenceChanges;
+    bool Joinable;
+    std::vector<ovrUser>* Friends;
+    size_t FriendsPage;
+    double InviteQuota;         // SendInvites per second, 0 = unlimited
+    double InviteBurst;
+    double InviteTokens;
+    uint64_t InviteRefillNs;
+
+    std::vector<ovrMessage*>* Replies[MESSAGE_NAME_COUNT];  // Recorded responses, in order
+    size_t RepliesUsed[MESSAGE_NAME_COUNT];
+
+    uint64_t Requests;
+    uint64_t Replayed;
+    uint64_t InjectedErrors;
+    uint64_t FloodMessages;
+    uint64_t PanelsClosedAtOnce;
+    uint64_t UserPages;
+    uint64_t Invites;
+    uint64_t InvitesOverQuota;
+} g_Stub = {PTHREAD_MUTEX_INITIALIZER};
+
+static uint64_t StubNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static ovrMessage* NewMessage(ovrMessageType type, ovrRequest requestId, uint64_t dueNs) {
+    ovrMessage* message = (ovrMessage*)calloc(1, sizeof(ovrMessage));
+    message->Type = type;
+    message->RequestId = requestId;
+    message->DueNs = dueNs;
+    message->JoinIntent = DEFAULT_JOIN_INTENT;
+    message->LeaveIntent = DEFAULT_LEAVE_INTENT;
+    return message;
+}
+
+// Caller holds g_Stub.Lock.
+static void QueueMessageLocked(ovrMessage* message) {
+    message->Sequence = g_Stub.NextSequence++;
+    g_Stub.Queue->push(message);
+}
+
+// Caller holds g_Stub.Lock.
+static ovrMessage* PushMessageLocked(ovrMessageType type, ovrRequest requestId, uint64_t dueNs, const char* error) {
+    ovrMessage* message = NewMessage(type, requestId, dueNs);
+    if (error) {
+        message->IsError = true;
+        message->Error.Code = 1;
+        snprintf(message->Error.Message, sizeof(message->Error.Message), "%s", error);
+    }
+    QueueMessageLocked(message);
+    return message;
+}
+
+static int MessageNameIndex(ovrMessageType type) {
+    for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+        if (MESSAGE_NAMES[i].Type == type) return i;
+    }
+    return -1;
+}
+
+// splitmix64. Caller holds g_Stub.Lock.
+static uint64_t RandomLocked() {
+    uint64_t z = (g_Stub.Random += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1). Caller holds g_Stub.Lock.
+static double UniformLocked() {
+    return (double)(RandomLocked() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Standard normal, Box-Muller. Caller holds g_Stub.Lock.
+static double GaussianLocked() {
+    double u = 1.0 - UniformLocked();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * UniformLocked());
+}
+
+// Caller holds g_Stub.Lock.
+static uint64_t SampleLatencyNsLocked(const LatencySpec* spec) {
+    double ms = spec->A;
+    switch (spec->Kind) {
+        case LATENCY_FIXED: break;
+        case LATENCY_UNIFORM: ms = spec->A + (spec->B - spec->A) * UniformLocked(); break;
+        case LATENCY_NORMAL: ms = spec->A + spec->B * GaussianLocked(); break;
+        case LATENCY_LOGNORMAL: ms = spec->A * exp(spec->B * GaussianLocked()); break;
+        case LATENCY_EXP: ms = -spec->A * log(1.0 - UniformLocked()); break;
+    }
+    return ms > 0 ? (uint64_t)(ms * 1e6) : 0;
+}
+
+// Applies the presence changes the server has answered by now and returns
+// whether the user is joinable. Caller holds g_Stub.Lock.
+static bool PresenceJoinableLocked(uint64_t now) {
+    std::vector<PresenceChange>* changes = g_Stub.PresenceChanges;
+    const PresenceChange* newest = NULL;
+    for (const PresenceChange& change : *changes) {
+        if (change.DueNs <= now && (!newest || change.Request > newest->Request)) newest = &change;
+    }
+    if (newest) {
+        g_Stub.Joinable = newest->Joinable;
+        ovrRequest applied = newest->Request;
+        for (size_t i = 0; i < changes->size();) {
+            if ((*changes)[i].Request <= applied) {
+                (*changes)[i] = changes->back();    // Older changes can never win again
+                changes->pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+    return g_Stub.Joinable;
+}
+
+enum PresenceEffect { PRESENCE_NONE, PRESENCE_NOT_JOINABLE, PRESENCE_JOINABLE };
+
+#define NO_PAGE ((size_t)-1)
+
+// Points the message's user array at the friends list page starting at offset.
+// Caller holds g_Stub.Lock.
+static void FillPageLocked(ovrMessage* message, size_t offset) {
+    const std::vector<ovrUser>& friends = *g_Stub.Friends;
+    if (offset > friends.size()) offset = friends.size();
+    size_t size = friends.size() - offset < g_Stub.FriendsPage ? friends.size() - offset : g_Stub.FriendsPage;
+    message->Users.Size = size;
+    message->Users.Users = friends.data() + offset;
+    message->Users.Offset = offset;
+    message->Users.HasNextPage = offset + size < friends.size();
+    g_Stub.UserPages++;
+}
+
+// Next recorded response of this API, or NULL. It keeps its recorded due time
+// and sequence even when the request comes late, so it still pops in recorded
+// order. Caller holds g_Stub.Lock.
+static ovrMessage* ClaimReplyLocked(int api) {
+    std::vector<ovrMessage*>* replies = g_Stub.Replies[api];
+    if (!replies || g_Stub.RepliesUsed[api] == replies->size()) return NULL;
+    return (*replies)[g_Stub.RepliesUsed[api]++];
+}
+
+// Takes a SendInvites request from the quota's token bucket. Returns false when
+// it is over quota. Caller holds g_Stub.Lock.
+static bool InviteQuotaLocked(uint64_t now) {
+    if (g_Stub.InviteQuota <= 0) return true;
+    g_Stub.InviteTokens += (now - g_Stub.InviteRefillNs) * g_Stub.InviteQuota / 1e9;
+    if (g_Stub.InviteTokens > g_Stub.InviteBurst) g_Stub.InviteTokens = g_Stub.InviteBurst;
+    g_Stub.InviteRefillNs = now;
+    if (g_Stub.InviteTokens < 1.0) return false;
+    g_Stub.InviteTokens -= 1.0;
+    return true;
+}
+
+// Issues a request. Its response is the next recorded one when replaying, or
+// else arrives after a latency drawn for its API, as an error at the API's
+// error rate. A successful user array response holds the friends list page
+// starting at page, a successful SendInvites response lists invites invites.
+static ovrRequest RespondLater(ovrMessageType type, PresenceEffect presence = PRESENCE_NONE,
+                               size_t page = NO_PAGE, uint32_t invites = 0) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    ovrRequest requestId = ++g_Stub.NextRequest;
+    if (g_Stub.Queue) {
+        int api = MessageNameIndex(type);
+        uint64_t now = StubNow();
+        ovrMessage* reply = ClaimReplyLocked(api);
+        uint64_t dueNs = reply ? reply->DueNs : now + SampleLatencyNsLocked(&g_Stub.Latency[api]);
+        bool fail = reply ? reply->IsError : g_Stub.ErrorRate[api] > 0 && UniformLocked() < g_Stub.ErrorRate[api];
+        if (presence != PRESENCE_NONE && !fail) {
+            g_Stub.PresenceChanges->push_back({dueNs, requestId, presence == PRESENCE_JOINABLE});
+        }
+        ovrMessage* message = reply;
+        if (reply) {
+            reply->RequestId = requestId;
+            g_Stub.Queue->push(reply);
+            g_Stub.Replayed++;
+        } else {
+            if (type == ovrMessage_GroupPresence_LaunchInvitePanel && !fail) {
+                if (PresenceJoinableLocked(now)) {
+                    dueNs += g_Stub.PanelNs;    // Open while the user picks
+                } else {
+                    g_Stub.PanelsClosedAtOnce++;
+                }
+            }
+            const char* error = fail ? "Injected error (OVRSTUB_ERRORS)" : NULL;
+            if (type == ovrMessage_GroupPresence_SendInvites && !fail && !InviteQuotaLocked(now)) {
+                error = "Rate limit exceeded (OVRSTUB_INVITE_QUOTA)";
+                fail = true;
+                g_Stub.InvitesOverQuota++;
+            } else {
+                g_Stub.InjectedErrors += fail;
+            }
+            message = PushMessageLocked(type, requestId, dueNs, error);
+            if (!fail) {
+                message->SendInvitesResult.Invites.Size = invites;
+                g_Stub.Invites += invites;
+            }
+        }
+        if (page != NO_PAGE && !fail) {
+            FillPageLocked(message, page);
+        }
+        g_Stub.Requests++;
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return requestId;
+}
+
+// Queues every flood burst that is due by now. Caller holds g_Stub.Lock.
+static void FloodLocked(uint64_t now) {
+    for (int i = 0; i < g_Stub.FloodCount; i++) {
+        Flood* flood = &g_Stub.Floods[i];
+        while (flood->NextNs <= now && (flood->EndNs == 0 || flood->NextNs < flood->EndNs)) {
+            for (uint32_t j = 0; j < flood->Burst; j++) {
+                PushMessageLocked(flood->Type, 0, flood->NextNs, NULL);
+            }
+            g_Stub.FloodMessages += flood->Burst;
+            flood->NextNs += flood->IntervalNs;
+        }
+    }
+}
+
+static bool ParseMessageType(const char* token, ovrMessageType* type) {
+    for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+        if (strcmp(token, MESSAGE_NAMES[i].Name) == 0) {
+            *type = MESSAGE_NAMES[i].Type;
+            return true;
+        }
+    }
+    char* end = NULL;
+    unsigned long value = strtoul(token, &end, 16);
+    if (end == token || *end != '\0') return false;
+    *type = (ovrMessageType)value;
+    return true;
+}
+
+// Caller holds g_Stub.Lock.
+static void LoadScriptLocked(uint64_t startNs) {
+    const char* path = getenv("OVRSTUB_SCRIPT");
+    if (!path) return;
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        STUB_LOG("cannot open OVRSTUB_SCRIPT %s", path);
+        return;
+    }
+
+    char line[512];
+    int lineNumber = 0;
+    uint64_t total = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNumber++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char* error = strchr(line, '!');
+        if (error) *error++ = '\0';
+
+        char typeName[128];
+        unsigned long long atMs = 0;
+        unsigned long count = 1;
+        int fields = sscanf(line, "%llu %127s %lu", &atMs, typeName, &count);
+        if (fields <= 0) continue;     // Blank or comment line
+        ovrMessageType type;
+        if (fields < 2 || !ParseMessageType(typeName, &type)) {
+            STUB_LOG("%s:%d: expected <at_ms> <type> [count] [!error]", path, lineNumber);
+            continue;
+        }
+        for (unsigned long i = 0; i < count; i++) {
+            PushMessageLocked(type, 0, startNs + atMs * 1000000ull, error);
+        }
+        total += count;
+    }
+    fclose(f);
+    STUB_LOG("scripted %llu messages from %s", (unsigned long long)total, path);
+}
+
+// Copies a recorded string into the message's Text and returns it.
+static const char* ReplayText(ovrMessage* message, size_t* used, const char* data, size_t length) {
+    static const size_t TEXT_SIZE = 1024;
+    if (!message->Text) message->Text = (char*)malloc(TEXT_SIZE);
+    if (*used >= TEXT_SIZE) return "";
+    if (*used + length + 1 > TEXT_SIZE) length = TEXT_SIZE - *used - 1;
+    char* text = message->Text + *used;
+    memcpy(text, data, length);
+    text[length] = '\0';
+    *used += length + 1;
+    return text;
+}
+
+// Decodes one field into the message it belongs to.
+static void ReplayField(ovrMessage* message, size_t* textUsed, uint16_t tag, const char* data, uint16_t length) {
+    switch (tag) {
+        case RECORDING_TAG_ERROR_MESSAGE:
+            snprintf(message->Error.Message, sizeof(message->Error.Message), "%.*s", (int)length, data);
+            break;
+        case RECORDING_TAG_DEEPLINK_MESSAGE:
+            message->JoinIntent.DeeplinkMessage = ReplayText(message, textUsed, data, length);
+            break;
+        case RECORDING_TAG_DESTINATION:
+            message->JoinIntent.DestinationApiName = message->LeaveIntent.DestinationApiName =
+                ReplayText(message, textUsed, data, length);
+            break;
+        case RECORDING_TAG_LOBBY_SESSION:
+            message->JoinIntent.LobbySessionId = message->LeaveIntent.LobbySessionId =
+                ReplayText(message, textUsed, data, length);
+            break;
+        case RECORDING_TAG_MATCH_SESSION:
+            message->JoinIntent.MatchSessionId = message->LeaveIntent.MatchSessionId =
+                ReplayText(message, textUsed, data, length);
+            break;
+        case RECORDING_TAG_INVITED_USERS: {
+            uint32_t users = 0;
+            memcpy(&users, data, length < sizeof(users) ? length : sizeof(users));
+            message->InvitePanelFlowResult.InvitedUsers.Size = users;
+            message->SendInvitesResult.Invites.Size = users;
+            break;
+        }
+        case RECORDING_TAG_INVITES_SENT:
+            message->InvitePanelResult.InvitesSent = length > 0 && data[0] != 0;
+            break;
+        default:
+            break;      // Newer field
+    }
+}
+
+// Queues the recording's notifications and sets its responses aside for the
+// requests to come. Caller holds g_Stub.Lock.
+static void LoadReplayLocked(uint64_t startNs) {
+    const char* path = getenv("OVRSTUB_REPLAY");
+    if (!path) return;
+    FILE* f = fopen(path, "rb");
+    ovrRecordingHeader header;
+    if (!f || fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.Magic, RECORDING_MAGIC, sizeof(header.Magic)) != 0 || header.Version != RECORDING_VERSION) {
+        STUB_LOG("cannot replay %s: not a version %d recording", path, RECORDING_VERSION);
+        if (f) fclose(f);
+        return;
+    }
+    fseek(f, header.HeaderSize, SEEK_SET);
+    const char* speedText = getenv("OVRSTUB_REPLAY_SPEED");
+    double speed = speedText ? atof(speedText) : 1.0;
+
+    uint64_t notifications = 0, replies = 0;
+    ovrMessage* message = NULL;
+    size_t textUsed = 0;
+    ovrRecordingField field;
+    char data[UINT16_MAX];
+    for (;;) {
+        bool more = fread(&field, sizeof(field), 1, f) == 1 && fread(data, 1, field.Length, f) == field.Length;
+        if (message && (!more || field.Tag == RECORDING_TAG_MESSAGE)) {
+            int api = MessageNameIndex(message->Type);
+            message->Sequence = g_Stub.NextSequence++;
+            if (message->RequestId == 0 || api < 0) {
+                g_Stub.Queue->push(message);    // Unknown responses keep their recorded ID
+                notifications++;
+            } else {
+                if (!g_Stub.Replies[api]) g_Stub.Replies[api] = new std::vector<ovrMessage*>();
+                g_Stub.Replies[api]->push_back(message);
+                replies++;
+            }
+            message = NULL;
+        }
+        if (!more) break;
+        if (field.Tag == RECORDING_TAG_MESSAGE && field.Length >= sizeof(ovrRecordedMessage)) {
+            ovrRecordedMessage recorded;
+            memcpy(&recorded, data, sizeof(recorded));
+            ovrMessageType type = (ovrMessageType)recorded.Type;
+            if (type == ovrMessage_PlatformInitializeAndroidAsynchronous) {
+                type = ovrMessage_PlatformInitializeWindowsAsynchronous;    // Device recordings
+            }
+            uint64_t offsetNs = speed > 0 ? (uint64_t)(recorded.TimeNs / speed) : 0;
+            message = NewMessage(type, recorded.RequestId, startNs + offsetNs);
+            message->JoinIntent = {"", "", "", ""};     // Empty strings are not recorded
+            message->LeaveIntent = {"", "", ""};
+            message->IsError = (recorded.Flags & RECORDING_FLAG_ERROR) != 0;
+            message->Error.Code = recorded.ErrorCode;
+            textUsed = 0;
+        } else if (message) {
+            ReplayField(message, &textUsed, field.Tag, data, field.Length);
+        }
+    }
+    fclose(f);
+    STUB_LOG("replaying %s at %gx: %llu notifications, %llu responses", path, speed,
+             (unsigned long long)notifications, (unsigned long long)replies);
+}
+
+static bool ParseLatency(const char* text, LatencySpec* spec) {
+    char kind[16];
+    double a = 0, b = 0;
+    int fields = sscanf(text, "%15[a-z]:%lf,%lf", kind, &a, &b);
+    if (fields < 2) {
+        // A bare number is a fixed latency
+        char* end = NULL;
+        a = strtod(text, &end);
+        if (end == text || *end != '\0') return false;
+        *spec = {LATENCY_FIXED, a, 0};
+        return true;
+    }
+    static const struct { const char* Name; LatencyKind Kind; int Params; } KINDS[] = {
+        {"fixed", LATENCY_FIXED, 1}, {"uniform", LATENCY_UNIFORM, 2}, {"normal", LATENCY_NORMAL, 2},
+        {"lognormal", LATENCY_LOGNORMAL, 2}, {"exp", LATENCY_EXP, 1},
+    };
+    for (const auto& k : KINDS) {
+        if (strcmp(kind, k.Name) != 0) continue;
+        if (fields - 1 < k.Params) return false;
+        *spec = {k.Kind, a, b};
+        return true;
+    }
+    return false;
+}
+
+// Parses "[<api>=]<value>;..." from the environment variable and calls apply
+// with the MESSAGE_NAMES index, or -1 for all APIs ("*" or no prefix).
+template <typename Apply>
+static void ParsePerApiList(const char* variable, Apply apply) {
+    const char* env = getenv(variable);
+    if (!env) return;
+    char list[1024];
+    snprintf(list, sizeof(list), "%s", env);
+    char* save = NULL;
+    for (char* entry = strtok_r(list, ";", &save); entry; entry = strtok_r(NULL, ";", &save)) {
+        int api = -1;
+        char* value = entry;
+        char* equals = strchr(entry, '=');
+        if (equals) {
+            *equals = '\0';
+            value = equals + 1;
+            ovrMessageType type;
+            if (strcmp(entry, "*") != 0) {
+                api = ParseMessageType(entry, &type) ? MessageNameIndex(type) : -1;
+                if (api < 0) {
+                    STUB_LOG("%s: unknown API %s", variable, entry);
+                    continue;
+                }
+            }
+        }
+        if (!apply(api, value)) {
+            STUB_LOG("%s: cannot parse %s", variable, value);
+        }
+    }
+}
+
+// Caller holds g_Stub.Lock.
+static void LoadConfigLocked(uint64_t startNs) {
+    const char* seed = getenv("OVRSTUB_SEED");
+    g_Stub.Random = seed ? strtoull(seed, NULL, 10) : 1;
+    const char* latency = getenv("OVRSTUB_LATENCY_MS");
+    LatencySpec fixed = {LATENCY_FIXED, latency ? atof(latency) : 50.0, 0};
+    for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+        g_Stub.Latency[i] = fixed;
+    }
+    ParsePerApiList("OVRSTUB_LATENCY", [](int api, const char* value) {
+        LatencySpec spec;
+        if (!ParseLatency(value, &spec)) return false;
+        for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+            if (api < 0 || api == i) g_Stub.Latency[i] = spec;
+        }
+        return true;
+    });
+    ParsePerApiList("OVRSTUB_ERRORS", [](int api, const char* value) {
+        char* end = NULL;
+        double rate = strtod(value, &end);
+        if (end == value || rate < 0 || rate > 1) return false;
+        for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+            if (api < 0 || api == i) g_Stub.ErrorRate[i] = rate;
+        }
+        return true;
+    });
+
+    const char* floods = getenv("OVRSTUB_FLOOD");
+    if (floods) {
+        char list[1024];
+        snprintf(list, sizeof(list), "%s", floods);
+        char* save = NULL;
+        for (char* entry = strtok_r(list, ";", &save); entry; entry = strtok_r(NULL, ";", &save)) {
+            char typeName[128];
+            double perSecond = 0;
+            unsigned burst = 1;
+            unsigned long long startMs = 0, durationMs = 0;
+            ovrMessageType type;
+            int fields = sscanf(entry, "%127[^:]:%lf:%u:%llu:%llu", typeName, &perSecond, &burst, &startMs,
+                                &durationMs);
+            if (fields < 2 || perSecond <= 0 || burst == 0 || !ParseMessageType(typeName, &type)) {
+                STUB_LOG("OVRSTUB_FLOOD: expected <type>:<per_second>[:<burst>[:<start_ms>[:<duration_ms>]]], got %s",
+                         entry);
+                continue;
+            }
+            if (g_Stub.FloodCount == MAX_FLOODS) {
+                STUB_LOG("OVRSTUB_FLOOD: more than %d floods", MAX_FLOODS);
+                break;
+            }
+            uint64_t firstNs = startNs + startMs * 1000000ull;
+            g_Stub.Floods[g_Stub.FloodCount++] = {
+                type, burst, (uint64_t)(burst * 1e9 / perSecond), firstNs,
+                durationMs ? firstNs + durationMs * 1000000ull : 0,
+            };
+        }
+    }
+
+    const char* panel = getenv("OVRSTUB_PANEL_MS");
+    g_Stub.PanelNs = (uint64_t)(panel ? atoi(panel) : 0) * 1000000ull;
+
+    static const char* const FIRST_NAMES[] = {
+        "Alex", "Sam", "Jordan", "Riley", "Casey", "Morgan", "Taylor", "Jamie", "Avery", "Quinn",
+    };
+    const char* quota = getenv("OVRSTUB_INVITE_QUOTA");
+    if (quota) {
+        double burst = 0;
+        if (sscanf(quota, "%lf:%lf", &g_Stub.InviteQuota, &burst) < 1 || g_Stub.InviteQuota < 0) {
+            STUB_LOG("OVRSTUB_INVITE_QUOTA: expected <per_second>[:<burst>], got %s", quota);
+            g_Stub.InviteQuota = 0;
+        }
+        g_Stub.InviteBurst = burst >= 1 ? burst : 1;
+        g_Stub.InviteTokens = g_Stub.InviteBurst;
+        g_Stub.InviteRefillNs = startNs;
+    }
+
+    const char* friends = getenv("OVRSTUB_FRIENDS");
+    const char* friendsPage = getenv("OVRSTUB_FRIENDS_PAGE");
+    long friendCount = friends ? atol(friends) : 100;
+    long pageSize = friendsPage ? atol(friendsPage) : 50;
+    g_Stub.FriendsPage = pageSize > 0 ? (size_t)pageSize : 50;
+    for (long i = 0; i < friendCount; i++) {
+        ovrUser user = {};
+        user.Id = 1000000000000000ull + (uint64_t)i * 7919;
+        const char* name = FIRST_NAMES[i % (sizeof(FIRST_NAMES) / sizeof(FIRST_NAMES[0]))];
+        snprintf(user.DisplayName, sizeof(user.DisplayName), "%s %ld", name, i + 1);
+        snprintf(user.OculusId, sizeof(user.OculusId), "stub_friend_%ld", i + 1);
+        g_Stub.Friends->push_back(user);
+    }
+}
+
+static void ReportAtExit() {
+    STUB_LOG("%llu requests (%llu replayed), %llu injected errors, %llu flood messages, "
+             "%llu invite panels closed at once, %llu user pages, %llu invites (%llu requests over quota)",
+             (unsigned long long)g_Stub.Requests, (unsigned long long)g_Stub.Replayed,
+             (unsigned long long)g_Stub.InjectedErrors,
+             (unsigned long long)g_Stub.FloodMessages, (unsigned long long)g_Stub.PanelsClosedAtOnce,
+             (unsigned long long)g_Stub.UserPages, (unsigned long long)g_Stub.Invites,
+             (unsigned long long)g_Stub.InvitesOverQuota);
+}
+
+// ================================================================================
+// Initialization and the message queue
+// ================================================================================
+OVRPL_PUBLIC_FUNCTION(ovrRequest) ovr_PlatformInitializeWindowsAsynchronousEx(
+        const char* appId, ovrPlatformInitializeResult* outResult, int productVersion, int majorVersion) {
+    pthread_mutex_lock(&g_Stub.Lock);
+    if (!g_Stub.Queue) {
+        g_Stub.Queue = new std::priority_queue<ovrMessage*, std::vector<ovrMessage*>, MessageLater>();
+        g_Stub.PresenceChanges = new std::vector<PresenceChange>();
+        g_Stub.Friends = new std::vector<ovrUser>();
+        uint64_t now = StubNow();
+        LoadConfigLocked(now);
+        LoadScriptLocked(now);
+        LoadReplayLocked(now);
+        atexit(ReportAtExit);
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+
+    if (outResult) *outResult = ovrPlatformInitialize_Success;
+    STUB_LOG("init app %s", appId);
+    return RespondLater(ovrMessage_PlatformInitializeWindowsAsynchronous);
+}
+
+OVRP_PUBLIC_FUNCTION(bool) ovr_IsPlatformInitialized() {
+    return g_Stub.Queue != NULL;
+}
+
+OVRPL_PUBLIC_FUNCTION(ovrMessageHandle) ovr_PopMessage() {
+    ovrMessage* message = NULL;
+    pthread_mutex_lock(&g_Stub.Lock);
+    uint64_t now = StubNow();
+    if (g_Stub.Queue) {
+        FloodLocked(now);
+    }
+    if (g_Stub.Queue && !g_Stub.Queue->empty() && g_Stub.Queue->top()->DueNs <= now) {
+        message = g_Stub.Queue->top();
+        g_Stub.Queue->pop();
+    }
+    pthread_mutex_unlock(&g_Stub.Lock);
+    return message;
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_FreeMessage(ovrMessageHandle message) {
+    free(message->Text);
+    free(message);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrMessageType) ovr_Message_GetType(const ovrMessageHandle obj) {
+    return obj->Type;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_Message_GetRequestID(const ovrMessageHandle obj) {
+    return obj->RequestId;
+}
+
+OVRP_PUBLIC_FUNCTION(bool) ovr_Message_IsError(const ovrMessageHandle obj) {
+    return obj->IsError;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrErrorHandle) ovr_Message_GetError(const ovrMessageHandle obj) {
+    return obj->IsError ? &obj->Error : NULL;
+}
+
+OVRPL_PUBLIC_FUNCTION(const char*) ovrMessageType_ToString(ovrMessageType value) {
+    int index = MessageNameIndex(value);
+    return index >= 0 ? MESSAGE_NAMES[index].Name : "Unknown";
+}
+
+OVRP_PUBLIC_FUNCTION(int) ovr_Error_GetCode(const ovrErrorHandle obj) {
+    return obj ? obj->Code : 0;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_Error_GetMessage(const ovrErrorHandle obj) {
+    return obj ? obj->Message : "";
+}
+
+// ================================================================================
+// Group presence
+// ================================================================================
+OVRP_PUBLIC_FUNCTION(ovrGroupPresenceOptionsHandle) ovr_GroupPresenceOptions_Create() {
+    return (ovrGroupPresenceOptionsHandle)calloc(1, sizeof(ovrGroupPresenceOptions));
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_GroupPresenceOptions_Destroy(ovrGroupPresenceOptionsHandle handle) {
+    free(handle);
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_GroupPresenceOptions_SetDestinationApiName(ovrGroupPresenceOptionsHandle handle,
+                                                                          const char * value) {
+    snprintf(handle->DestinationApiName, sizeof(handle->DestinationApiName), "%s", value);
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_GroupPresenceOptions_SetIsJoinable(ovrGroupPresenceOptionsHandle handle, bool value) {
+    handle->IsJoinable = value;
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_GroupPresenceOptions_SetLobbySessionId(ovrGroupPresenceOptionsHandle handle,
+                                                                      const char * value) {
+    snprintf(handle->LobbySessionId, sizeof(handle->LobbySessionId), "%s", value);
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_GroupPresenceOptions_SetMatchSessionId(ovrGroupPresenceOptionsHandle handle,
+                                                                      const char * value) {
+    snprintf(handle->MatchSessionId, sizeof(handle->MatchSessionId), "%s", value);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrInviteOptionsHandle) ovr_InviteOptions_Create() {
+    return (ovrInviteOptionsHandle)calloc(1, sizeof(ovrInviteOptions));
+}
+
+OVRP_PUBLIC_FUNCTION(void) ovr_InviteOptions_Destroy(ovrInviteOptionsHandle handle) {
+    free(handle);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_GroupPresence_Set(ovrGroupPresenceOptionsHandle groupPresenceOptions) {
+    return RespondLater(ovrMessage_GroupPresence_Set,
+                        groupPresenceOptions->IsJoinable ? PRESENCE_JOINABLE : PRESENCE_NOT_JOINABLE);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_GroupPresence_Clear() {
+    return RespondLater(ovrMessage_GroupPresence_Clear, PRESENCE_NOT_JOINABLE);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_GroupPresence_LaunchInvitePanel(ovrInviteOptionsHandle options) {
+    return RespondLater(ovrMessage_GroupPresence_LaunchInvitePanel);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_GroupPresence_GetInvitableUsers(ovrInviteOptionsHandle options) {
+    return RespondLater(ovrMessage_GroupPresence_GetInvitableUsers, PRESENCE_NONE, 0);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_GroupPresence_SendInvites(ovrID *userIDs, unsigned int userIDLength) {
+    return RespondLater(ovrMessage_GroupPresence_SendInvites, PRESENCE_NONE, NO_PAGE, userIDLength);
+}
+
+OVRP_PUBLIC_FUNCTION(ovrRequest) ovr_User_GetNextUserArrayPage(ovrUserArrayHandle handle) {
+    return RespondLater(ovrMessage_User_GetNextUserArrayPage, PRESENCE_NONE, handle->Offset + handle->Size);
+}
+
+// ================================================================================
+// Payloads
+// ================================================================================
+OVRP_PUBLIC_FUNCTION(ovrGroupPresenceJoinIntentHandle) ovr_Message_GetGroupPresenceJoinIntent(const ovrMessageHandle obj) {
+    return obj->Type == ovrMessage_Notification_GroupPresence_JoinIntentReceived ? &obj->JoinIntent : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrGroupPresenceLeaveIntentHandle) ovr_Message_GetGroupPresenceLeaveIntent(const ovrMessageHandle obj) {
+    return obj->Type == ovrMessage_Notification_GroupPresence_LeaveIntentReceived ? &obj->LeaveIntent : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrLaunchInvitePanelFlowResultHandle) ovr_Message_GetLaunchInvitePanelFlowResult(const ovrMessageHandle obj) {
+    return obj->Type == ovrMessage_Notification_GroupPresence_InvitationsSent ? &obj->InvitePanelFlowResult : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrInvitePanelResultInfoHandle) ovr_Message_GetInvitePanelResultInfo(const ovrMessageHandle obj) {
+    return obj->Type == ovrMessage_GroupPresence_LaunchInvitePanel && !obj->IsError ? &obj->InvitePanelResult : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrSendInvitesResultHandle) ovr_Message_GetSendInvitesResult(const ovrMessageHandle obj) {
+    return obj->Type == ovrMessage_GroupPresence_SendInvites && !obj->IsError ? &obj->SendInvitesResult : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrUserArrayHandle) ovr_Message_GetUserArray(const ovrMessageHandle obj) {
+    bool page = obj->Type == ovrMessage_GroupPresence_GetInvitableUsers ||
+                obj->Type == ovrMessage_User_GetNextUserArrayPage;
+    return page && !obj->IsError ? &obj->Users : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceJoinIntent_GetDeeplinkMessage(const ovrGroupPresenceJoinIntentHandle obj) {
+    return obj->DeeplinkMessage;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceJoinIntent_GetDestinationApiName(const ovrGroupPresenceJoinIntentHandle obj) {
+    return obj->DestinationApiName;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceJoinIntent_GetLobbySessionId(const ovrGroupPresenceJoinIntentHandle obj) {
+    return obj->LobbySessionId;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceJoinIntent_GetMatchSessionId(const ovrGroupPresenceJoinIntentHandle obj) {
+    return obj->MatchSessionId;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceLeaveIntent_GetDestinationApiName(const ovrGroupPresenceLeaveIntentHandle obj) {
+    return obj->DestinationApiName;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceLeaveIntent_GetLobbySessionId(const ovrGroupPresenceLeaveIntentHandle obj) {
+    return obj->LobbySessionId;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_GroupPresenceLeaveIntent_GetMatchSessionId(const ovrGroupPresenceLeaveIntentHandle obj) {
+    return obj->MatchSessionId;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrUserArrayHandle) ovr_LaunchInvitePanelFlowResult_GetInvitedUsers(const ovrLaunchInvitePanelFlowResultHandle obj) {
+    return &obj->InvitedUsers;
+}
+
+OVRP_PUBLIC_FUNCTION(size_t) ovr_UserArray_GetSize(const ovrUserArrayHandle obj) {
+    return obj->Size;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrUserHandle) ovr_UserArray_GetElement(const ovrUserArrayHandle obj, size_t index) {
+    return obj->Users && index < obj->Size ? (ovrUserHandle)&obj->Users[index] : NULL;
+}
+
+OVRP_PUBLIC_FUNCTION(bool) ovr_UserArray_HasNextPage(const ovrUserArrayHandle obj) {
+    return obj->HasNextPage;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_UserArray_GetNextUrl(const ovrUserArrayHandle obj) {
+    return obj->HasNextPage ? "stub://friends/next" : "";
+}
+
+OVRP_PUBLIC_FUNCTION(ovrID) ovr_User_GetID(const ovrUserHandle obj) {
+    return obj->Id;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_User_GetDisplayName(const ovrUserHandle obj) {
+    return obj->DisplayName;
+}
+
+OVRP_PUBLIC_FUNCTION(const char *) ovr_User_GetOculusID(const ovrUserHandle obj) {
+    return obj->OculusId;
+}
+
+OVRP_PUBLIC_FUNCTION(ovrApplicationInviteArrayHandle) ovr_SendInvitesResult_GetInvites(const ovrSendInvitesResultHandle obj) {
+    return &obj->Invites;
+}
+
+OVRP_PUBLIC_FUNCTION(size_t) ovr_ApplicationInviteArray_GetSize(const ovrApplicationInviteArrayHandle obj) {
+    return obj->Size;
+}
+
+OVRP_PUBLIC_FUNCTION(bool) ovr_InvitePanelResultInfo_GetInvitesSent(const ovrInvitePanelResultInfoHandle obj) {
+    return obj->InvitesSent;
+}
@@ -9,22 +9,40 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
 #include <time.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <coroutine>
+#include <type_traits>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
+#ifdef __ANDROID__
+#include <sys/system_properties.h>
 #include <android/log.h>
 #include <android/native_window_jni.h>
 #include <android_native_app_glue.h>
+#endif
 
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <GLES3/gl3.h>
 #include <GLES3/gl3ext.h>
+#include <GLES2/gl2ext.h>
 
 #define XR_USE_GRAPHICS_API_OPENGL_ES 1
+#ifdef __ANDROID__
 #define XR_USE_PLATFORM_ANDROID 1
+#else
+#define XR_USE_PLATFORM_EGL 1       // Headless benchmark build (XR_MNDX_egl_enable)
+#endif
+#define XR_USE_TIMESPEC 1
 #include <openxr/openxr.h>
 #include <openxr/openxr_platform.h>
 
@@ -36,15 +54,71 @@
 // Oculus Platform SDK (includes all necessary headers)
 #include <OVR_Platform.h>
 
+#include "xr_recording_format.h"
+#include "xr_trace_format.h"
+
 #define TAG "XrPresenceTest"
-#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, TAG, __VA_ARGS__)
-#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN, TAG, __VA_ARGS__)
-#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO, TAG, __VA_ARGS__)
-#define ALOGV(...) __android_log_print(ANDROID_LOG_VERBOSE, TAG, __VA_ARGS__)
+
+// Log priorities, numerically the same as android_LogPriority
+#define LOG_PRIO_VERBOSE 2
+#define LOG_PRIO_DEBUG 3
+#define LOG_PRIO_INFO 4
+#define LOG_PRIO_WARN 5
+#define LOG_PRIO_ERROR 6
+
+// Statements below this priority compile to nothing: their arguments are never
+// evaluated or formatted. Release (NDEBUG) builds keep INFO and up.
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LOG_PRIO_INFO
+#else
+#define LOG_COMPILE_LEVEL LOG_PRIO_VERBOSE
+#endif
+#endif
+
+typedef enum {
+    LOG_CAT_APP,
+    LOG_CAT_XR,
+    LOG_CAT_INPUT,
+    LOG_CAT_PLATFORM,
+    LOG_CAT_RENDER,
+    LOG_CAT_COUNT
+} ovrLogCategory;
+
+static const char* const LOG_CATEGORY_NAMES[LOG_CAT_COUNT] = {"app", "xr", "input", "platform", "render"};
+
+// Runtime minimum priority per category ("debug.xrpresence.log_level[_<category>]"),
+// and how many compiled-in statements each one filtered out.
+static int g_LogLevels[LOG_CAT_COUNT] = {LOG_PRIO_INFO, LOG_PRIO_INFO, LOG_PRIO_INFO, LOG_PRIO_INFO, LOG_PRIO_INFO};
+static uint64_t g_LogSuppressed[LOG_CAT_COUNT];
+
+// Formats on the calling thread and queues the line for the log sink thread
+static void LogSink_Printf(int priority, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// Filtered statements cost a load and a compare; only enabled ones format.
+#define LOG_AT(prio, cat, fmt, ...) do { \
+    if constexpr ((prio) >= LOG_COMPILE_LEVEL) { \
+        if ((prio) >= __atomic_load_n(&g_LogLevels[cat], __ATOMIC_RELAXED)) { \
+            LogSink_Printf(prio, "%s: " fmt, LOG_CATEGORY_NAMES[cat], ##__VA_ARGS__); \
+        } else { \
+            __atomic_add_fetch(&g_LogSuppressed[cat], 1, __ATOMIC_RELAXED); \
+        } \
+    } \
+} while (0)
+
+// Category is the ovrLogCategory suffix: LOGI(PLATFORM, "...")
+#define LOGE(cat, fmt, ...) LOG_AT(LOG_PRIO_ERROR, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOGW(cat, fmt, ...) LOG_AT(LOG_PRIO_WARN, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOGI(cat, fmt, ...) LOG_AT(LOG_PRIO_INFO, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOGD(cat, fmt, ...) LOG_AT(LOG_PRIO_DEBUG, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOGV(cat, fmt, ...) LOG_AT(LOG_PRIO_VERBOSE, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
 
 #ifndef EGL_OPENGL_ES3_BIT_KHR
 #define EGL_OPENGL_ES3_BIT_KHR 0x0040
 #endif
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
 
 #define MATH_PI 3.14159265358979323846f
 
@@ -52,21 +126,78 @@
 static const char* DESTINATION_API_NAME = "test-location";
 static const char* APP_ID = "33969008956076849";
 
-// UI Panel dimensions
-static const int UI_WIDTH = 1024;
-static const int UI_HEIGHT = 1183;
+// UI panels. Each one is an ImGui window packed into a shared atlas swapchain
+// and shown through its own quad layer.
+typedef enum {
+    PANEL_STATUS,
+    PANEL_CONTROLS,
+    PANEL_LOG,
+    PANEL_DIAGNOSTICS,
+    PANEL_FRIENDS,
+    PANEL_INSTRUCTIONS,
+    PANEL_COUNT
+} ovrPanelId;
+
+// Idle mode (resumed, no running session) looper timeouts
+static const int IDLE_TIMEOUT_MS = 50;
+static const int IDLE_BURST_TIMEOUT_MS = 5;
+static const uint64_t IDLE_BURST_NS = 500000000ull;  // Fast polling after Platform traffic
+
+// Reads an integer tuning knob from the "debug.xrpresence.<name>" system property,
+// e.g. `adb shell setprop debug.xrpresence.pipelined 1` before launching the app.
+// The headless build reads the XRPRESENCE_<NAME> environment variable instead.
+static int GetConfigInt(const char* name, int defaultValue) {
+#ifdef __ANDROID__
+    char key[96];
+    char value[PROP_VALUE_MAX] = {0};
+    snprintf(key, sizeof(key), "debug.xrpresence.%s", name);
+    if (__system_property_get(key, value) <= 0) {
+        return defaultValue;
+    }
+    return atoi(value);
+#else
+    char key[96];
+    int len = snprintf(key, sizeof(key), "XRPRESENCE_%s", name);
+    for (int i = 0; i < len && i < (int)sizeof(key); i++) {
+        if (key[i] >= 'a' && key[i] <= 'z') key[i] -= 'a' - 'A';
+    }
+    const char* value = getenv(key);
+    return (value && value[0]) ? atoi(value) : defaultValue;
+#endif
+}
+
+// Runtime log levels: "log_level" for every category, then "log_level_<category>"
+// overrides, as LOG_PRIO_* values (2 verbose .. 6 error).
+static void LoadLogLevels() {
+    int level = GetConfigInt("log_level", LOG_PRIO_INFO);
+    for (int cat = 0; cat < LOG_CAT_COUNT; cat++) {
+        char name[32];
+        snprintf(name, sizeof(name), "log_level_%s", LOG_CATEGORY_NAMES[cat]);
+        g_LogLevels[cat] = GetConfigInt(name, level);
+    }
+}
 
 // Forward declaration for error checking
 static XrInstance g_Instance = XR_NULL_HANDLE;
 XrInstance GetXrInstance() { return g_Instance; }
 
-// OpenXR error checking macro
+// Times the enclosing block as a span in the Chrome trace export (Span Trace below).
+struct TraceScope {
+    const char* Name;
+    const char* Category;
+    uint64_t Start;
+    TraceScope(const char* name, const char* category);
+    ~TraceScope();
+};
+
+// OpenXR error checking macro. Every call is also a span in the trace export.
 #define OXR(func) do { \
+    TraceScope _scope(#func, "xr"); \
     XrResult _result = func; \
     if (XR_FAILED(_result)) { \
         char errorBuffer[XR_MAX_RESULT_STRING_SIZE]; \
         xrResultToString(g_Instance, _result, errorBuffer); \
-        ALOGE("OpenXR error: %s: %s", #func, errorBuffer); \
+        LOGE(XR, "OpenXR error: %s: %s", #func, errorBuffer); \
     } \
 } while(0)
 
@@ -79,6 +210,7 @@ typedef struct {
     uint32_t Height;
     uint32_t ImageCount;
     GLuint* ColorTextures;
+    GLuint* Framebuffers;   // One complete FBO per swapchain image
 } ovrSwapChain;
 
 // ================================================================================
@@ -92,8 +224,20 @@ typedef struct {
 } ovrEgl;
 
 static void ovrEgl_CreateContext(ovrEgl* egl) {
+#ifdef __ANDROID__
     egl->Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+#else
+    // CI machines have no window system; Mesa's surfaceless platform needs none
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    egl->Display = getPlatformDisplay ?
+        getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL) : EGL_NO_DISPLAY;
+    if (egl->Display == EGL_NO_DISPLAY) {
+        egl->Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+#endif
     eglInitialize(egl->Display, NULL, NULL);
+    eglBindAPI(EGL_OPENGL_ES_API);
 
     const EGLint configAttribs[] = {
         EGL_RED_SIZE, 8,
@@ -104,6 +248,7 @@ static void ovrEgl_CreateContext(ovrEgl* egl) {
         EGL_STENCIL_SIZE, 0,
         EGL_SAMPLES, 0,
         EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
         EGL_NONE
     };
 
@@ -126,7 +271,7 @@ static void ovrEgl_CreateContext(ovrEgl* egl) {
 
     eglMakeCurrent(egl->Display, egl->TinySurface, egl->TinySurface, egl->Context);
 
-    ALOGI("EGL context created");
+    LOGI(RENDER, "EGL context created");
 }
 
 static void ovrEgl_DestroyContext(ovrEgl* egl) {
@@ -146,9 +291,12 @@ static void ovrEgl_DestroyContext(ovrEgl* egl) {
 // ================================================================================
 // Swapchain functions
 // ================================================================================
-static void ovrSwapChain_Create(XrSession session, ovrSwapChain* sc, int width, int height) {
+// createFlags may include XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT for content that is
+// rendered once; such a swapchain allows a single acquire over its lifetime.
+static void ovrSwapChain_Create(XrSession session, ovrSwapChain* sc, int width, int height,
+                                XrSwapchainCreateFlags createFlags) {
     XrSwapchainCreateInfo swapchainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
-    swapchainCreateInfo.createFlags = 0;
+    swapchainCreateInfo.createFlags = createFlags;
     swapchainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
     swapchainCreateInfo.format = GL_SRGB8_ALPHA8;
     swapchainCreateInfo.sampleCount = 1;
@@ -180,13 +328,34 @@ static void ovrSwapChain_Create(XrSession session, ovrSwapChain* sc, int width,
     }
 
     free(images);
-    ALOGI("Swapchain created: %dx%d, %u images", width, height, sc->ImageCount);
+
+    // Attach each image to its own framebuffer once, so the frame loop only binds
+    // and tiled GPUs never see an attachment change that forces revalidation.
+    sc->Framebuffers = (GLuint*)malloc(sc->ImageCount * sizeof(GLuint));
+    glGenFramebuffers(sc->ImageCount, sc->Framebuffers);
+    for (uint32_t i = 0; i < sc->ImageCount; i++) {
+        glBindFramebuffer(GL_FRAMEBUFFER, sc->Framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                               sc->ColorTextures[i], 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            LOGE(RENDER, "Swapchain framebuffer %u incomplete: 0x%x", i, status);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    LOGI(RENDER, "Swapchain created: %dx%d, %u images%s", width, height, sc->ImageCount,
+          (createFlags & XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) ? ", static" : "");
 }
 
 static void ovrSwapChain_Destroy(ovrSwapChain* sc) {
+    if (sc->Framebuffers) {
+        glDeleteFramebuffers(sc->ImageCount, sc->Framebuffers);
+    }
     if (sc->Handle != XR_NULL_HANDLE) {
         OXR(xrDestroySwapchain(sc->Handle));
     }
+    free(sc->Framebuffers);
     free(sc->ColorTextures);
     memset(sc, 0, sizeof(ovrSwapChain));
 }
@@ -195,7 +364,11 @@ static void ovrSwapChain_Destroy(ovrSwapChain* sc) {
 // Application State
 // ================================================================================
 typedef struct {
+#ifdef __ANDROID__
     struct android_app* NativeApp;
+    JNIEnv* Env;
+#endif
+    const char* DataPath;  // Writable directory for dumps (adb pull-able when external)
 
     ovrEgl Egl;
     XrSystemId SystemId;
@@ -203,8 +376,7 @@ typedef struct {
     XrSpace LocalSpace;
     XrSpace HeadSpace;
 
-    ovrSwapChain UiSwapChain;
-    GLuint UiFramebuffer;
+    ovrSwapChain UiSwapChain;   // Panel atlas
 
     bool Resumed;
     bool SessionActive;
@@ -219,7 +391,6 @@ typedef struct {
     char LobbyId[64];
     char MatchSessionId[64];
     char StatusText[256];
-    char LogBuffer[8192];
 
     // Toggles for testing different parameter combinations
     bool UseDestination;
@@ -236,12 +407,57 @@ typedef struct {
     XrPath LeftHandPath;
     XrPath RightHandPath;
 
-    // Cursor state
+    // Cursor state, in atlas coordinates
     float CursorX;
     float CursorY;
+    int HoverPanel;     // Panel under the aim ray, -1 when it misses them all
+    bool ScriptedPose;          // Aim pose from a deterministic script instead of the controller
+    uint64_t InputSyncTime;     // Monotonic time of this frame's xrSyncActions
     bool TriggerPressed;
     bool TriggerJustPressed;
     int SelectedButton;
+
+    // Panel change detection - skip acquire/render/release when nothing changed
+    XrCompositionLayerQuad PanelLayers[PANEL_COUNT];
+    bool UiLayerValid;           // Render side: an atlas image has been released
+    bool PanelHashValid;         // Build side
+    uint64_t LastPanelHash;      // Build side
+    uint64_t PanelFramesRendered;
+    uint64_t PanelFramesSkipped;
+    uint64_t PanelSkippedShown;  // Value drawn in the panel, latched on render
+    // Log counters drawn in the panel. They move every frame while a per-frame
+    // statement is filtered or written, so they are latched on render at most
+    // once a second; live values would change the panel hash every frame.
+    uint64_t LogWrittenShown;
+    uint64_t LogDroppedShown;
+    uint64_t LogSuppressedShown[LOG_CAT_COUNT];
+    uint64_t LogLatchNs;         // Render side
+
+    // Static panels: own single-image swapchain each, re-created on content change
+    ovrSwapChain StaticSwapChains[PANEL_COUNT];  // Render side
+    bool StaticHashValid[PANEL_COUNT];           // Build side
+    uint64_t StaticHash[PANEL_COUNT];            // Build side
+
+    // Idle mode: last time Platform SDK traffic arrived, for the short poll burst
+    uint64_t LastPlatformMessageTime;
+    uint64_t IdlePeriodWallNs;  // Current idle period, logged when it ends
+    uint64_t IdlePeriodCpuNs;
+    uint64_t PlatformMessagesHandled;
+    int AutoFlow;                   // Once the Platform SDK is up: 1 runs TestCorrectFlow,
+                                    // 2 TestSetClearSetFlow
+    bool ActionsAttached;
+
+    // Two-stage pipeline: UI build on the main thread, GL/xrEndFrame on a render thread
+    bool Pipelined;
+
+    // Adaptive panel resolution (build side except GpuPanelTimeNs)
+    bool AdaptiveResolution;
+    int PanelScaleLevel;        // Index into PANEL_SCALE_LEVELS
+    float PanelLoad;            // Smoothed max(CPU, GPU) time / display period
+    int OverBudgetFrames;
+    int UnderBudgetFrames;
+    int ScaleCooldownFrames;
+    uint64_t GpuPanelTimeNs;    // GPU time of a panel render not yet counted, 0 if none; written by the render side
 } ovrApp;
 
 static ovrApp appState;
@@ -249,291 +465,2945 @@ static ovrApp appState;
 // ================================================================================
 // Logging
 // ================================================================================
+// The in-app log is a fixed-capacity ring. Line text is packed into a byte
+// ring, and a parallel ring of line records holds each line's position, length,
+// timestamp and severity. Appends are O(1) regardless of how much is logged;
+// when either ring fills up the oldest whole lines are evicted.
+#define LOG_DEFAULT_LINES 2048
+#define LOG_BYTES_PER_LINE 96       // Text ring sizing, average line length
+#define LOG_MAX_LINE 512
+
+typedef enum {
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+} ovrLogLevel;
+
+typedef struct {
+    uint64_t Offset;    // Monotonic byte position of the text; wraps modulo TextCapacity
+    uint32_t Length;
+    ovrLogLevel Level;
+    uint64_t TimeNs;
+} ovrLogLine;
+
+typedef struct {
+    char* Text;
+    uint64_t TextCapacity;
+    ovrLogLine* Lines;
+    uint32_t LineCapacity;
+    uint64_t FirstLine;     // Monotonic index of the oldest retained line
+    uint64_t EndLine;       // One past the newest line
+    uint64_t TextEnd;       // Monotonic byte position after the newest line
+    uint64_t Evicted;       // Lines dropped to make room
+    uint64_t Version;       // Bumped on every change, for panel change detection
+    uint64_t StartTimeNs;
+} ovrLogRing;
+
+static ovrLogRing g_Log;
+
+static uint64_t GetTimeNanos();
+
+static void LogRing_Init(ovrLogRing* log, uint32_t lineCapacity) {
+    log->LineCapacity = lineCapacity;
+    log->TextCapacity = (uint64_t)lineCapacity * LOG_BYTES_PER_LINE;
+    if (log->TextCapacity < 2 * LOG_MAX_LINE) log->TextCapacity = 2 * LOG_MAX_LINE;
+    log->Lines = (ovrLogLine*)calloc(log->LineCapacity, sizeof(ovrLogLine));
+    log->Text = (char*)malloc(log->TextCapacity);
+    log->StartTimeNs = GetTimeNanos();
+}
+
+static void LogRing_Destroy(ovrLogRing* log) {
+    free(log->Lines);
+    free(log->Text);
+    memset(log, 0, sizeof(ovrLogRing));
+}
+
+static uint32_t LogRing_Count(const ovrLogRing* log) {
+    return (uint32_t)(log->EndLine - log->FirstLine);
+}
+
+// Line i counting from the oldest retained one; the text is not NUL-terminated.
+static const ovrLogLine* LogRing_Get(const ovrLogRing* log, uint32_t i, const char** text) {
+    const ovrLogLine* line = &log->Lines[(log->FirstLine + i) % log->LineCapacity];
+    *text = log->Text + line->Offset % log->TextCapacity;
+    return line;
+}
+
+static void LogRing_Clear(ovrLogRing* log) {
+    log->FirstLine = log->EndLine;
+    log->Version++;
+}
+
+static void LogRing_Append(ovrLogRing* log, ovrLogLevel level, const char* text, uint32_t length) {
+    if (length > LOG_MAX_LINE) length = LOG_MAX_LINE;
+
+    // Lines are stored contiguously, so one that would straddle the end of the
+    // text ring starts over at its beginning instead
+    uint64_t offset = log->TextEnd;
+    uint64_t room = log->TextCapacity - offset % log->TextCapacity;
+    if (room < length) offset += room;
+
+    // Evict whole lines until both the record and its text fit
+    while (log->FirstLine < log->EndLine &&
+           (log->EndLine - log->FirstLine >= log->LineCapacity ||
+            offset + length - log->Lines[log->FirstLine % log->LineCapacity].Offset > log->TextCapacity)) {
+        log->FirstLine++;
+        log->Evicted++;
+    }
+
+    ovrLogLine* line = &log->Lines[log->EndLine % log->LineCapacity];
+    line->Offset = offset;
+    line->Length = length;
+    line->Level = level;
+    line->TimeNs = GetTimeNanos();
+    memcpy(log->Text + offset % log->TextCapacity, text, length);
+    log->TextEnd = offset + length;
+    log->EndLine++;
+    log->Version++;
+}
+
+static void AppendLogV(ovrLogLevel level, const char* fmt, va_list args) {
+    char temp[LOG_MAX_LINE];
+    int length = vsnprintf(temp, sizeof(temp), fmt, args);
+    if (length < 0) return;
+    if (length >= (int)sizeof(temp)) length = sizeof(temp) - 1;
+
+    switch (level) {
+        case LOG_LEVEL_ERROR: LOGE(APP, "%s", temp); break;
+        case LOG_LEVEL_WARN: LOGW(APP, "%s", temp); break;
+        default: LOGI(APP, "%s", temp); break;
+    }
+    if (g_Log.Lines) {
+        LogRing_Append(&g_Log, level, temp, (uint32_t)length);
+    }
+}
+
 static void AppendLog(const char* fmt, ...) {
-    char temp[512];
     va_list args;
     va_start(args, fmt);
-    vsnprintf(temp, sizeof(temp), fmt, args);
+    AppendLogV(LOG_LEVEL_INFO, fmt, args);
     va_end(args);
+}
 
-    size_t logLen = strlen(appState.LogBuffer);
-    size_t tempLen = strlen(temp);
-    if (logLen + tempLen + 2 > sizeof(appState.LogBuffer) - 100) {
-        memmove(appState.LogBuffer, appState.LogBuffer + 1024, logLen - 1024 + 1);
-        logLen = strlen(appState.LogBuffer);
-    }
-    strcat(appState.LogBuffer, temp);
-    strcat(appState.LogBuffer, "\n");
+static void AppendLogWarn(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    AppendLogV(LOG_LEVEL_WARN, fmt, args);
+    va_end(args);
+}
 
-    ALOGI("%s", temp);
+static void AppendLogError(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    AppendLogV(LOG_LEVEL_ERROR, fmt, args);
+    va_end(args);
 }
 
 // ================================================================================
-// Platform SDK Message Pump
+// Log Sink
 // ================================================================================
-static void ProcessPlatformMessages() {
-    ovrMessageHandle message = nullptr;
-    while ((message = ovr_PopMessage()) != nullptr) {
-        ovrMessageType msgType = ovr_Message_GetType(message);
-        bool isError = ovr_Message_IsError(message);
-
-        // Log ALL messages for debugging
-        ALOGI("Platform message received: type=%d, isError=%d", (int)msgType, isError);
-
-        switch (msgType) {
-            case ovrMessage_PlatformInitializeAndroidAsynchronous:
-                ALOGI("Got Platform init callback! isError=%d", isError);
-                if (isError) {
-                    ovrErrorHandle error = ovr_Message_GetError(message);
-                    const char* errMsg = ovr_Error_GetMessage(error);
-                    ALOGE("Platform init FAILED: %s", errMsg);
-                    AppendLog("Platform init FAILED: %s", errMsg);
-                } else {
-                    ALOGI("Platform SDK initialized successfully!");
-                    AppendLog("Platform SDK initialized successfully!");
-                    appState.PlatformInitialized = true;
-                }
-                break;
+// LOG* never writes to logcat (stderr off-device) on the calling thread. The
+// line is formatted straight into a slot of a bounded lock-free MPSC queue
+// (Vyukov's sequence-numbered ring) and a background thread does the writes.
+// When the queue is full the record is dropped and counted instead of blocking.
+// Before the sink starts and after it stops, lines are written synchronously.
+#define LOG_SINK_DEFAULT_RECORDS 1024
+#define LOG_SINK_MAX_RECORDS 65536
+#define LOG_SINK_TEXT 500
 
-            case ovrMessage_GroupPresence_Set:
-                if (isError) {
-                    ovrErrorHandle error = ovr_Message_GetError(message);
-                    AppendLog("GroupPresence_Set FAILED: %s", ovr_Error_GetMessage(error));
-                    appState.PresenceSet = false;
-                    appState.IsJoinable = false;
-                } else {
-                    AppendLog("Group presence set successfully!");
-                    appState.PresenceSet = true;
-                    appState.IsJoinable = true;
-                    snprintf(appState.StatusText, sizeof(appState.StatusText),
-                             "Presence SET - Ready to invite!");
-                }
-                break;
+typedef struct {
+    uint64_t Sequence;
+    int Priority;
+    char Text[LOG_SINK_TEXT];
+} ovrLogRecord;
 
-            case ovrMessage_GroupPresence_LaunchInvitePanel:
-                if (isError) {
-                    ovrErrorHandle error = ovr_Message_GetError(message);
-                    AppendLog("LaunchInvitePanel FAILED: %s", ovr_Error_GetMessage(error));
-                } else {
-                    AppendLog("Invite panel closed");
-                }
-                break;
+typedef struct {
+    ovrLogRecord* Records;
+    uint64_t Mask;
+    uint64_t EnqueuePos;        // Shared by producers
+    uint64_t DequeuePos;        // Sink thread only
+    bool Running;
+    bool Quit;
+    bool Sleeping;              // Sink thread is (about to be) blocked on Cond
+    uint64_t Written;
+    uint64_t Dropped;
+    pthread_t Thread;
+    pthread_mutex_t Mutex;
+    pthread_cond_t Cond;
+} ovrLogSink;
+
+static ovrLogSink g_LogSink;
+
+static void LogSink_Write(int priority, const char* text) {
+#ifdef __ANDROID__
+    __android_log_write(priority, TAG, text);
+#else
+    static const char LEVELS[] = "??VDIWEF";
+    fprintf(stderr, "%c/%s: %s\n", LEVELS[priority & 7], TAG, text);
+#endif
+}
 
-            case ovrMessage_GroupPresence_Clear:
-                if (isError) {
-                    ovrErrorHandle error = ovr_Message_GetError(message);
-                    AppendLog("GroupPresence_Clear FAILED: %s", ovr_Error_GetMessage(error));
-                } else {
-                    AppendLog("Group presence cleared successfully");
-                }
-                break;
+static void LogSink_Printf(int priority, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    if (!__atomic_load_n(&g_LogSink.Running, __ATOMIC_ACQUIRE)) {
+        char text[LOG_SINK_TEXT];
+        vsnprintf(text, sizeof(text), fmt, args);
+        va_end(args);
+        LogSink_Write(priority, text);
+        return;
+    }
 
-            default:
-                // Log unknown message types for debugging
-                ALOGV("Unhandled Platform message type: %d", (int)msgType);
+    // Claim a slot: its sequence equals the position while it is free
+    ovrLogRecord* record;
+    uint64_t pos = __atomic_load_n(&g_LogSink.EnqueuePos, __ATOMIC_RELAXED);
+    for (;;) {
+        record = &g_LogSink.Records[pos & g_LogSink.Mask];
+        uint64_t seq = __atomic_load_n(&record->Sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&g_LogSink.EnqueuePos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
                 break;
+            }
+        } else if (diff < 0) {
+            va_end(args);
+            __atomic_add_fetch(&g_LogSink.Dropped, 1, __ATOMIC_RELAXED);
+            return;     // Full
+        } else {
+            pos = __atomic_load_n(&g_LogSink.EnqueuePos, __ATOMIC_RELAXED);
         }
+    }
 
-        ovr_FreeMessage(message);
+    record->Priority = priority;
+    vsnprintf(record->Text, sizeof(record->Text), fmt, args);
+    va_end(args);
+    __atomic_store_n(&record->Sequence, pos + 1, __ATOMIC_RELEASE);
+
+    // Only a sleeping sink needs waking, so a busy one costs no syscall. The
+    // fence orders the publish before the Sleeping load; it pairs with the one
+    // in LogSinkThreadMain, so either the sink sees the record or we see it asleep.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&g_LogSink.Sleeping, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&g_LogSink.Mutex);
+        pthread_cond_signal(&g_LogSink.Cond);
+        pthread_mutex_unlock(&g_LogSink.Mutex);
     }
 }
 
-// ================================================================================
-// Presence Functions (Real Oculus Platform SDK)
-// ================================================================================
-static void GenerateLobbyId() {
-    snprintf(appState.LobbyId, sizeof(appState.LobbyId), "lobby_%d_%ld",
-             rand() % 10000, (long)time(NULL));
-    AppendLog("Generated lobby ID: %s", appState.LobbyId);
+// Writes every published record. Returns the number written.
+static int LogSink_Drain(ovrLogSink* sink) {
+    int count = 0;
+    for (;;) {
+        ovrLogRecord* record = &sink->Records[sink->DequeuePos & sink->Mask];
+        if (__atomic_load_n(&record->Sequence, __ATOMIC_ACQUIRE) != sink->DequeuePos + 1) {
+            break;
+        }
+        LogSink_Write(record->Priority, record->Text);
+        __atomic_store_n(&record->Sequence, sink->DequeuePos + sink->Mask + 1, __ATOMIC_RELEASE);
+        sink->DequeuePos++;
+        count++;
+    }
+    if (count > 0) {
+        __atomic_add_fetch(&sink->Written, count, __ATOMIC_RELAXED);
+    }
+    return count;
 }
 
-static void GenerateMatchSessionId() {
-    snprintf(appState.MatchSessionId, sizeof(appState.MatchSessionId), "match_%d_%ld",
-             rand() % 10000, (long)time(NULL));
-    AppendLog("Generated match session ID: %s", appState.MatchSessionId);
+static bool LogSink_Empty(ovrLogSink* sink) {
+    const ovrLogRecord* record = &sink->Records[sink->DequeuePos & sink->Mask];
+    return __atomic_load_n(&record->Sequence, __ATOMIC_ACQUIRE) != sink->DequeuePos + 1;
 }
 
-static void SetGroupPresence() {
-    if (!appState.PlatformInitialized) {
-        AppendLog("ERROR: Platform SDK not initialized yet!");
-        return;
-    }
-
-    AppendLog("Setting group presence with params:");
-
-    // Create and configure presence options
-    ovrGroupPresenceOptionsHandle options = ovr_GroupPresenceOptions_Create();
-
-    if (appState.UseDestination) {
-        ovr_GroupPresenceOptions_SetDestinationApiName(options, DESTINATION_API_NAME);
-        AppendLog("  Destination: %s", DESTINATION_API_NAME);
-    } else {
-        AppendLog("  Destination: (not set)");
-    }
+static void* LogSinkThreadMain(void* arg) {
+    ovrLogSink* sink = (ovrLogSink*)arg;
+    prctl(PR_SET_NAME, (long)"XrLogSink", 0, 0, 0);
+
+    uint64_t reportedDrops = 0;
+    for (;;) {
+        LogSink_Drain(sink);
+
+        uint64_t dropped = __atomic_load_n(&sink->Dropped, __ATOMIC_RELAXED);
+        if (dropped != reportedDrops) {
+            char text[96];
+            snprintf(text, sizeof(text), "Log sink queue full, dropped %llu records (%llu total)",
+                     (unsigned long long)(dropped - reportedDrops), (unsigned long long)dropped);
+            LogSink_Write(LOG_PRIO_WARN, text);
+            reportedDrops = dropped;
+        }
 
-    if (appState.UseLobbyId) {
-        if (strlen(appState.LobbyId) == 0) {
-            AppendLog("  WARNING: LobbyId enabled but empty!");
+        // Sleeping is published before the final emptiness check (the fence
+        // keeps the check from being ordered ahead of it), and producers signal
+        // under the mutex, so a wakeup cannot slip in between
+        pthread_mutex_lock(&sink->Mutex);
+        __atomic_store_n(&sink->Sleeping, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        while (LogSink_Empty(sink) && !sink->Quit) {
+            pthread_cond_wait(&sink->Cond, &sink->Mutex);
         }
-        ovr_GroupPresenceOptions_SetLobbySessionId(options, appState.LobbyId);
-        AppendLog("  LobbyId: %s", appState.LobbyId);
-    } else {
-        AppendLog("  LobbyId: (not set)");
-    }
+        __atomic_store_n(&sink->Sleeping, false, __ATOMIC_RELAXED);
+        bool quit = sink->Quit;
+        pthread_mutex_unlock(&sink->Mutex);
 
-    if (appState.UseMatchSessionId) {
-        if (strlen(appState.MatchSessionId) == 0) {
-            AppendLog("  WARNING: MatchSessionId enabled but empty!");
+        if (quit) {
+            LogSink_Drain(sink);
+            break;
         }
-        ovr_GroupPresenceOptions_SetMatchSessionId(options, appState.MatchSessionId);
-        AppendLog("  MatchSessionId: %s", appState.MatchSessionId);
-    } else {
-        AppendLog("  MatchSessionId: (not set)");
     }
+    return NULL;
+}
 
-    if (appState.UseIsJoinable) {
-        ovr_GroupPresenceOptions_SetIsJoinable(options, true);
-        AppendLog("  IsJoinable: true");
-    } else {
-        AppendLog("  IsJoinable: (not set)");
+static void LogSink_Start(ovrLogSink* sink, uint32_t capacity) {
+    if (capacity == 0 || capacity > LOG_SINK_MAX_RECORDS) {
+        LOGW(APP, "Log queue size %u out of range, using %u records", capacity, LOG_SINK_DEFAULT_RECORDS);
+        capacity = LOG_SINK_DEFAULT_RECORDS;
     }
+    uint32_t size = 2;
+    while (size < capacity) size <<= 1;
+    sink->Records = (ovrLogRecord*)calloc(size, sizeof(ovrLogRecord));
+    sink->Mask = size - 1;
+    for (uint32_t i = 0; i < size; i++) {
+        sink->Records[i].Sequence = i;
+    }
+    sink->EnqueuePos = 0;
+    sink->DequeuePos = 0;
+    sink->Quit = false;
+    pthread_mutex_init(&sink->Mutex, NULL);
+    pthread_cond_init(&sink->Cond, NULL);
+    pthread_create(&sink->Thread, NULL, LogSinkThreadMain, sink);
+    __atomic_store_n(&sink->Running, true, __ATOMIC_RELEASE);
+}
 
-    // Send the request (async - response handled in ProcessPlatformMessages)
-    ovrRequest req = ovr_GroupPresence_Set(options);
-    ALOGI("ovr_GroupPresence_Set request: %llu", (unsigned long long)req);
+// Flushes everything queued, then falls back to synchronous writes. Producers
+// must be quiescent (other threads joined).
+static void LogSink_Stop(ovrLogSink* sink) {
+    if (!sink->Running) return;
+    __atomic_store_n(&sink->Running, false, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&sink->Mutex);
+    sink->Quit = true;
+    pthread_cond_signal(&sink->Cond);
+    pthread_mutex_unlock(&sink->Mutex);
+    pthread_join(sink->Thread, NULL);
+
+    pthread_cond_destroy(&sink->Cond);
+    pthread_mutex_destroy(&sink->Mutex);
+    free(sink->Records);
+    sink->Records = NULL;
+}
 
-    ovr_GroupPresenceOptions_Destroy(options);
+// ================================================================================
+// Platform Message Types
+// ================================================================================
+// Every ovrMessageType the SDK defines (ovr_message_types.h, generated from
+// OVR_MessageType.h) with its typed payload accessor. The type values are sparse
+// 32-bit hashes, so lookup goes through a multiplicative perfect hash whose
+// multiplier is searched for at compile time.
+static std::nullptr_t ovr_Message_GetNone(const ovrMessageHandle) { return nullptr; }  // Payload-less types
+
+// ovrMessagePayload<type>::Get(message) returns the type's payload, of ::Type
+template <ovrMessageType T>
+struct ovrMessagePayload;
+
+#define OVR_MESSAGE(name, payload) \
+    template <> \
+    struct ovrMessagePayload<ovrMessage_##name> { \
+        typedef decltype(ovr_Message_Get##payload(nullptr)) Type; \
+        static Type Get(ovrMessageHandle message) { return ovr_Message_Get##payload(message); } \
+    };
+#include "ovr_message_types.h"
+#undef OVR_MESSAGE
+
+static constexpr uint32_t MESSAGE_TYPES[] = {
+#define OVR_MESSAGE(name, payload) (uint32_t)ovrMessage_##name,
+#include "ovr_message_types.h"
+#undef OVR_MESSAGE
+};
+
+static const char* const MESSAGE_TYPE_NAMES[] = {
+#define OVR_MESSAGE(name, payload) #name,
+#include "ovr_message_types.h"
+#undef OVR_MESSAGE
+};
+
+static constexpr int MESSAGE_TYPE_COUNT = sizeof(MESSAGE_TYPES) / sizeof(MESSAGE_TYPES[0]);
+static constexpr int MESSAGE_HASH_BITS = 11;    // 2048 slots keeps a perfect multiplier quick to find
+static_assert(MESSAGE_TYPE_COUNT < 255, "hash slots hold the type index in a byte");
+
+static constexpr uint32_t MessageHash(uint32_t type, uint32_t multiplier) {
+    return (type * multiplier) >> (32 - MESSAGE_HASH_BITS);
+}
 
-    snprintf(appState.StatusText, sizeof(appState.StatusText), "Setting presence...");
+struct ovrMessageHashTable {
+    uint32_t Multiplier;
+    uint8_t Slots[1 << MESSAGE_HASH_BITS];  // Type index + 1, 0 when empty
+};
+
+static constexpr ovrMessageHashTable BuildMessageHashTable() {
+    ovrMessageHashTable table = {};
+    for (uint32_t multiplier = 0x9E3779B1u;; multiplier += 2) {
+        table = {};
+        bool perfect = true;
+        for (int i = 0; i < MESSAGE_TYPE_COUNT && perfect; i++) {
+            uint8_t& slot = table.Slots[MessageHash(MESSAGE_TYPES[i], multiplier)];
+            perfect = slot == 0;
+            slot = (uint8_t)(i + 1);
+        }
+        if (perfect) {
+            table.Multiplier = multiplier;
+            return table;
+        }
+    }
 }
 
-static void ClearGroupPresence() {
-    AppendLog("Clearing group presence...");
+static constexpr ovrMessageHashTable MESSAGE_HASH_TABLE = BuildMessageHashTable();
 
-    if (appState.PlatformInitialized) {
-        ovrRequest req = ovr_GroupPresence_Clear();
-        ALOGI("ovr_GroupPresence_Clear request: %llu", (unsigned long long)req);
-    }
+// Index into MESSAGE_TYPES, or -1 for a type the table does not know.
+static constexpr int MessageTypeIndex(ovrMessageType type) {
+    uint32_t value = (uint32_t)type;
+    int slot = MESSAGE_HASH_TABLE.Slots[MessageHash(value, MESSAGE_HASH_TABLE.Multiplier)];
+    return (slot != 0 && MESSAGE_TYPES[slot - 1] == value) ? slot - 1 : -1;
+}
 
-    appState.PresenceSet = false;
-    appState.IsJoinable = false;
-    appState.LobbyId[0] = '\0';
-    appState.MatchSessionId[0] = '\0';
-    snprintf(appState.StatusText, sizeof(appState.StatusText), "Presence cleared");
+static const char* MessageTypeName(ovrMessageType type) {
+    int index = MessageTypeIndex(type);
+    return index >= 0 ? MESSAGE_TYPE_NAMES[index] : "Unknown";
 }
 
-static void LaunchInvitePanel() {
-    if (!appState.PlatformInitialized) {
-        AppendLog("ERROR: Platform SDK not initialized yet!");
+// ================================================================================
+// Event Trace
+// ================================================================================
+// Compact binary trace of the events that matter for presence/invite debugging
+// (see xr_trace_format.h), decoded offline with Tools/xrtrace. Appending is an
+// atomic increment and a 32-byte store into a MAP_SHARED ring, with no syscalls,
+// so it stays on in production; the kernel keeps the pages if the app crashes.
+#define TRACE_DEFAULT_RECORDS 65536     // 2 MB
+#define TRACE_MAX_RECORDS (1u << 22)    // 128 MB
+
+typedef struct {
+    ovrTraceHeader* Header;     // NULL while tracing is off
+    ovrTraceRecord* Records;
+    uint64_t Mask;
+    size_t MapSize;
+} ovrTrace;
+
+static ovrTrace g_Trace;
+
+static void Trace_Emit(ovrTraceEvent event, uint32_t arg, int32_t value, uint64_t id, uint16_t flags) {
+    ovrTraceHeader* header = g_Trace.Header;
+    if (!header) return;
+    uint64_t index = __atomic_fetch_add(&header->WritePos, 1, __ATOMIC_RELAXED);
+    ovrTraceRecord* record = &g_Trace.Records[index & g_Trace.Mask];
+    __atomic_store_n(&record->Sequence, 0, __ATOMIC_RELAXED);     // Torn until rewritten
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    record->TimeNs = GetTimeNanos();
+    record->Id = id;
+    record->Arg = arg;
+    record->Value = value;
+    record->Event = (uint16_t)event;
+    record->Flags = flags;
+    __atomic_store_n(&record->Sequence, (uint32_t)(index + 1), __ATOMIC_RELEASE);
+}
+
+// Creates a fresh trace in dir, keeping the previous run's as TRACE_PREV_FILE_NAME.
+static void Trace_Open(const char* dir, uint32_t capacity) {
+    if (capacity == 0 || capacity > TRACE_MAX_RECORDS) {
+        LOGW(APP, "Trace size %u out of range, using %u records", capacity, TRACE_DEFAULT_RECORDS);
+        capacity = TRACE_DEFAULT_RECORDS;
+    }
+    uint32_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    char path[512];
+    char prevPath[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, TRACE_FILE_NAME);
+    snprintf(prevPath, sizeof(prevPath), "%s/%s", dir, TRACE_PREV_FILE_NAME);
+    rename(path, prevPath);
+
+    size_t mapSize = sizeof(ovrTraceHeader) + (size_t)size * sizeof(ovrTraceRecord);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)mapSize) != 0) {
+        LOGE(APP, "Trace FAILED: cannot create %s", path);
+        if (fd >= 0) close(fd);
         return;
     }
-
-    if (!appState.PresenceSet || !appState.IsJoinable) {
-        AppendLog("!! WARNING: Launching invite panel but:");
-        if (!appState.PresenceSet) AppendLog("   - Presence NOT set!");
-        if (!appState.IsJoinable) AppendLog("   - User NOT joinable!");
-        AppendLog("   This will cause panel to close immediately!");
+    void* map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);     // The mapping keeps the file alive
+    if (map == MAP_FAILED) {
+        LOGE(APP, "Trace FAILED: cannot map %s", path);
+        return;
     }
 
-    AppendLog("Launching invite panel...");
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    ovrTraceHeader* header = (ovrTraceHeader*)map;
+    memcpy(header->Magic, TRACE_MAGIC, sizeof(header->Magic));
+    header->Version = TRACE_VERSION;
+    header->HeaderSize = sizeof(ovrTraceHeader);
+    header->RecordSize = sizeof(ovrTraceRecord);
+    header->Capacity = size;
+    header->StartTimeNs = GetTimeNanos();
+    header->StartRealtimeNs = (uint64_t)realtime.tv_sec * 1000000000ull + (uint64_t)realtime.tv_nsec;
+    header->WritePos = 0;
+    header->Pid = (uint32_t)getpid();
+
+    g_Trace.Records = (ovrTraceRecord*)(header + 1);
+    g_Trace.Mask = size - 1;
+    g_Trace.MapSize = mapSize;
+    g_Trace.Header = header;
+    Trace_Emit(TRACE_EVENT_APP_START, 0, (int32_t)header->Pid, 0, 0);
+    LOGI(APP, "Tracing to %s (%u records)", path, size);
+}
 
-    // Create invite options (can be NULL for defaults, but let's be explicit)
-    ovrInviteOptionsHandle options = ovr_InviteOptions_Create();
+static void Trace_Close() {
+    if (!g_Trace.Header) return;
+    munmap(g_Trace.Header, g_Trace.MapSize);
+    g_Trace.Header = NULL;
+}
 
-    // Launch the system invite panel (async)
-    ovrRequest req = ovr_GroupPresence_LaunchInvitePanel(options);
-    ALOGI("ovr_GroupPresence_LaunchInvitePanel request: %llu", (unsigned long long)req);
+// ================================================================================
+// Span Trace
+// ================================================================================
+// Spans (TraceScope, every OXR call), Platform request lifetimes from issue to
+// response pop, and focus/lifecycle instants go into an in-memory ring that is
+// exported as Chrome trace-event JSON for Perfetto or chrome://tracing. Any
+// thread may record; slots are claimed with an atomic increment and committed
+// with a sequence number like the event trace.
+#define SPAN_DEFAULT_EVENTS 65536   // 4 MB, about a minute at 72 Hz
 
-    ovr_InviteOptions_Destroy(options);
+typedef struct {
+    const char* Name;       // Static storage; OXR names are cut at '(' on export
+    const char* Category;
+    uint64_t StartNs;
+    uint64_t DurationNs;
+    uint64_t Id;            // ovrRequest for async events
+    uint32_t Tid;
+    int32_t Value;          // Error code for async ends
+    char Phase;             // Chrome trace "ph": X, b, e or i
+    uint64_t Sequence;      // Record index + 1, written last
+} ovrSpanEvent;
 
-    snprintf(appState.StatusText, sizeof(appState.StatusText), "Opening invite panel...");
+typedef struct {
+    ovrSpanEvent* Events;   // NULL while span tracing is off
+    uint64_t Mask;
+    uint64_t WritePos;
+} ovrSpanRing;
+
+static ovrSpanRing g_Spans;
+
+static const char* const SESSION_STATE_NAMES[] = {
+    "XR_SESSION_STATE_UNKNOWN", "XR_SESSION_STATE_IDLE", "XR_SESSION_STATE_READY",
+    "XR_SESSION_STATE_SYNCHRONIZED", "XR_SESSION_STATE_VISIBLE", "XR_SESSION_STATE_FOCUSED",
+    "XR_SESSION_STATE_STOPPING", "XR_SESSION_STATE_LOSS_PENDING", "XR_SESSION_STATE_EXITING",
+};
+
+#ifdef __ANDROID__
+// android_native_app_glue APP_CMD_* in enum order
+static const char* const APP_CMD_NAMES[] = {
+    "APP_CMD_INPUT_CHANGED", "APP_CMD_INIT_WINDOW", "APP_CMD_TERM_WINDOW", "APP_CMD_WINDOW_RESIZED",
+    "APP_CMD_WINDOW_REDRAW_NEEDED", "APP_CMD_CONTENT_RECT_CHANGED", "APP_CMD_GAINED_FOCUS",
+    "APP_CMD_LOST_FOCUS", "APP_CMD_CONFIG_CHANGED", "APP_CMD_LOW_MEMORY", "APP_CMD_START",
+    "APP_CMD_RESUME", "APP_CMD_SAVE_STATE", "APP_CMD_PAUSE", "APP_CMD_STOP", "APP_CMD_DESTROY",
+};
+#endif
+
+static uint32_t GetThreadId() {
+    static thread_local uint32_t tid = 0;
+    if (tid == 0) tid = (uint32_t)syscall(SYS_gettid);
+    return tid;
 }
 
-static void TestBuggyFlow() {
-    AppendLog("=== BUGGY FLOW (Developer's Issue) ===");
-    AppendLog("Order: Panel -> Presence (WRONG!)");
-    AppendLog("Result: Panel closes immediately");
+static void Spans_Init(uint32_t capacity) {
+    uint32_t size = 2;
+    while (size < capacity) size <<= 1;
+    g_Spans.Events = (ovrSpanEvent*)calloc(size, sizeof(ovrSpanEvent));
+    g_Spans.Mask = size - 1;
+    g_Spans.WritePos = 0;
+}
 
-    LaunchInvitePanel();  // Called too early!
-    SetGroupPresence();   // Too late
+static void Spans_Record(char phase, const char* name, const char* category, uint64_t startNs,
+                         uint64_t durationNs, uint64_t id, int32_t value) {
+    if (!g_Spans.Events) return;
+    uint64_t index = __atomic_fetch_add(&g_Spans.WritePos, 1, __ATOMIC_RELAXED);
+    ovrSpanEvent* event = &g_Spans.Events[index & g_Spans.Mask];
+    __atomic_store_n(&event->Sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event->Name = name;
+    event->Category = category;
+    event->StartNs = startNs;
+    event->DurationNs = durationNs;
+    event->Id = id;
+    event->Tid = GetThreadId();
+    event->Value = value;
+    event->Phase = phase;
+    __atomic_store_n(&event->Sequence, index + 1, __ATOMIC_RELEASE);
 }
 
-static void TestCorrectFlow() {
-    AppendLog("=== CORRECT FLOW ===");
-    AppendLog("Order: Lobby -> Presence -> Panel");
+TraceScope::TraceScope(const char* name, const char* category)
+    : Name(name), Category(category), Start(g_Spans.Events ? GetTimeNanos() : 0) {}
 
-    GenerateLobbyId();
-    SetGroupPresence();
-    AppendLog("Now safe to open invite panel!");
+TraceScope::~TraceScope() {
+    if (Start != 0) {
+        Spans_Record('X', Name, Category, Start, GetTimeNanos() - Start, 0, 0);
+    }
 }
 
-// ================================================================================
-// ImGui Rendering
-// ================================================================================
-static bool g_ImGuiInitialized = false;
+static void Spans_Instant(const char* name, const char* category) {
+    Spans_Record('i', name, category, GetTimeNanos(), 0, 0, 0);
+}
 
-static void InitImGui() {
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
+static void Spans_AsyncBegin(const char* name, uint64_t id) {
+    Spans_Record('b', name, "platform", GetTimeNanos(), 0, id, 0);
+}
 
-    ImGuiIO& io = ImGui::GetIO();
-    io.IniFilename = NULL;
-    io.DisplaySize = ImVec2((float)UI_WIDTH, (float)UI_HEIGHT);
-    io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
-    io.FontGlobalScale = 2.5f;
+static void Spans_AsyncEnd(const char* name, uint64_t id, int32_t error) {
+    Spans_Record('e', name, "platform", GetTimeNanos(), 0, id, error);
+}
 
-    ImGui::StyleColorsDark();
-    ImGuiStyle& style = ImGui::GetStyle();
-    style.WindowRounding = 12.0f;
-    style.FrameRounding = 8.0f;
-    style.ItemSpacing = ImVec2(16, 12);
-    style.FramePadding = ImVec2(12, 8);
-    style.Colors[ImGuiCol_WindowBg] = ImVec4(0.08f, 0.08f, 0.12f, 0.95f);
-    style.Colors[ImGuiCol_Button] = ImVec4(0.2f, 0.4f, 0.8f, 1.0f);
-    style.Colors[ImGuiCol_ButtonHovered] = ImVec4(0.3f, 0.5f, 0.9f, 1.0f);
-    style.Colors[ImGuiCol_ButtonActive] = ImVec4(0.15f, 0.3f, 0.6f, 1.0f);
+// Writes a JSON string, stopping at '(' so "xrWaitFrame(session, ...)" becomes "xrWaitFrame".
+static void WriteJsonName(FILE* f, const char* name) {
+    fputc('"', f);
+    for (const char* c = name; *c && *c != '('; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', f);
+        fputc(*c, f);
+    }
+    fputc('"', f);
+}
 
-    ImGui_ImplOpenGL3_Init("#version 300 es");
-    g_ImGuiInitialized = true;
+// Exports everything still in the ring to <DataPath>/chrome_trace_<time>.json.
+static void Spans_ExportJson() {
+    if (!g_Spans.Events) {
+        AppendLogWarn("Trace export skipped: span tracing is off");
+        return;
+    }
+    char path[512];
+    snprintf(path, sizeof(path), "%s/chrome_trace_%ld.json",
+             appState.DataPath ? appState.DataPath : ".", (long)time(NULL));
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        AppendLogError("Trace export FAILED: cannot open %s", path);
+        return;
+    }
 
-    ALOGI("ImGui initialized");
-}
+    int pid = (int)getpid();
+    uint32_t tids[32];
+    int tidCount = 0;
+    uint64_t written = 0;
+    uint64_t end = __atomic_load_n(&g_Spans.WritePos, __ATOMIC_ACQUIRE);
+    uint64_t capacity = g_Spans.Mask + 1;
+    uint64_t begin = end > capacity ? end - capacity : 0;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (uint64_t index = begin; index < end; index++) {
+        const ovrSpanEvent* slot = &g_Spans.Events[index & g_Spans.Mask];
+        if (__atomic_load_n(&slot->Sequence, __ATOMIC_ACQUIRE) != index + 1) continue;
+        ovrSpanEvent event = *slot;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->Sequence, __ATOMIC_RELAXED) != index + 1) continue;  // Overwritten meanwhile
+
+        if (written++ > 0) fprintf(f, ",\n");
+        fprintf(f, "{\"ph\":\"%c\",\"name\":", event.Phase);
+        WriteJsonName(f, event.Name);
+        fprintf(f, ",\"cat\":\"%s\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f",
+                event.Category, pid, event.Tid, event.StartNs / 1000.0);
+        switch (event.Phase) {
+            case 'X':
+                fprintf(f, ",\"dur\":%.3f", event.DurationNs / 1000.0);
+                break;
+            case 'b':
+                fprintf(f, ",\"id\":\"0x%llx\"", (unsigned long long)event.Id);
+                break;
+            case 'e':
+                fprintf(f, ",\"id\":\"0x%llx\",\"args\":{\"error\":%d}", (unsigned long long)event.Id, event.Value);
+                break;
+            case 'i':
+                fprintf(f, ",\"s\":\"g\"");     // Global: a line across every track
+                break;
+        }
+        fprintf(f, "}");
 
-static void ShutdownImGui() {
-    if (g_ImGuiInitialized) {
-        ImGui_ImplOpenGL3_Shutdown();
-        ImGui::DestroyContext();
-        g_ImGuiInitialized = false;
+        int t = 0;
+        while (t < tidCount && tids[t] != event.Tid) t++;
+        if (t == tidCount && tidCount < (int)(sizeof(tids) / sizeof(tids[0]))) tids[tidCount++] = event.Tid;
+    }
+
+    // Thread names for the tracks, as set with PR_SET_NAME
+    for (int t = 0; t < tidCount; t++) {
+        char commPath[64];
+        char name[32] = "";
+        snprintf(commPath, sizeof(commPath), "/proc/self/task/%u/comm", tids[t]);
+        FILE* comm = fopen(commPath, "r");
+        if (comm) {
+            if (fgets(name, sizeof(name), comm)) name[strcspn(name, "\n")] = '\0';
+            fclose(comm);
+        }
+        fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                written + t > 0 ? ",\n" : "", pid, tids[t]);
+        WriteJsonName(f, name[0] ? name : "thread");
+        fprintf(f, "}}");
     }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    AppendLog("Trace exported: %s (%llu events)", path, (unsigned long long)written);
 }
 
-static void RenderImGuiToTexture(GLuint targetTexture) {
-    if (!g_ImGuiInitialized) return;
+// ================================================================================
+// Frame Profiler
+// ================================================================================
+// Always-on per-stage timing. Each stage keeps a ring of its most recent
+// durations; every stage is written by exactly one thread (main or render), so
+// the only synchronization needed is relaxed atomics for the panel reader.
+typedef enum {
+    PROFILE_STAGE_FRAME,        // Whole main-loop iteration
+    PROFILE_STAGE_EVENTS,       // ALooper + xrPollEvent
+    PROFILE_STAGE_PLATFORM,     // ProcessPlatformMessages
+    PROFILE_STAGE_WAIT_FRAME,
+    PROFILE_STAGE_INPUT,        // UpdateInput
+    PROFILE_STAGE_BUILD_UI,     // ImGui build + change hash
+    PROFILE_STAGE_BEGIN_FRAME,
+    PROFILE_STAGE_ACQUIRE,
+    PROFILE_STAGE_WAIT_IMAGE,
+    PROFILE_STAGE_RENDER_UI,    // RenderImGuiToTexture
+    PROFILE_STAGE_RELEASE,
+    PROFILE_STAGE_END_FRAME,
+    PROFILE_STAGE_GPU_UI,       // GPU time of the panel render (timer query)
+    PROFILE_STAGE_STATIC_PANEL, // Static panel swapchain re-creation + render
+    PROFILE_STAGE_IDLE_CPU,     // Main-thread CPU per idle wakeup (no session running)
+    PROFILE_STAGE_CURSOR_M2P,   // Aim pose sample to predicted display (motion-to-photon)
+    PROFILE_STAGE_COUNT
+} ovrProfileStage;
+
+static const char* PROFILE_STAGE_NAMES[PROFILE_STAGE_COUNT] = {
+    "Frame", "Events", "Platform", "WaitFrame", "Input", "BuildUI",
+    "BeginFrame", "Acquire", "WaitImage", "RenderUI", "Release", "EndFrame",
+    "GpuUI", "StaticPanel", "IdleCpu", "CursorM2P",
+};
+
+#define PROFILE_RING_SIZE 512
+#define PROFILE_HISTOGRAM_BINS 40   // 1 ms per bin
+#define PROFILE_STATS_INTERVAL_NS 500000000ull
 
-    // Bind framebuffer with target texture
-    glBindFramebuffer(GL_FRAMEBUFFER, appState.UiFramebuffer);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targetTexture, 0);
+typedef struct {
+    uint32_t Samples[PROFILE_STAGE_COUNT][PROFILE_RING_SIZE];  // Microseconds
+    uint32_t Count[PROFILE_STAGE_COUNT];                       // Total samples recorded
+
+    // Latched for display so the panel only changes twice a second
+    float P50[PROFILE_STAGE_COUNT];
+    float P95[PROFILE_STAGE_COUNT];
+    float P99[PROFILE_STAGE_COUNT];
+    float FrameHistogram[PROFILE_HISTOGRAM_BINS];
+    uint64_t LastStatsTime;
+
+    // Idle mode totals, main thread only
+    uint64_t IdleWallNs;
+    uint64_t IdleCpuNs;
+} ovrProfiler;
+
+static ovrProfiler g_Profiler;
+
+static uint64_t GetTimeNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
 
-    glViewport(0, 0, UI_WIDTH, UI_HEIGHT);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+static uint64_t GetThreadCpuNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
 
-    // Update ImGui input
-    ImGuiIO& io = ImGui::GetIO();
-    io.MousePos = ImVec2(appState.CursorX, appState.CursorY);
-    io.MouseDown[0] = appState.TriggerPressed;
+static void Profiler_Record(ovrProfileStage stage, uint64_t durationNs) {
+    uint64_t us = durationNs / 1000;
+    uint32_t count = __atomic_load_n(&g_Profiler.Count[stage], __ATOMIC_RELAXED);
+    __atomic_store_n(&g_Profiler.Samples[stage][count % PROFILE_RING_SIZE],
+                     (uint32_t)(us > UINT32_MAX ? UINT32_MAX : us), __ATOMIC_RELAXED);
+    __atomic_store_n(&g_Profiler.Count[stage], count + 1, __ATOMIC_RELEASE);
+}
 
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui::NewFrame();
+// Times the enclosing block into one profiler stage.
+struct ProfileScope {
+    ovrProfileStage Stage;
+    uint64_t Start;
+    explicit ProfileScope(ovrProfileStage stage) : Stage(stage), Start(GetTimeNanos()) {}
+    ~ProfileScope() { Profiler_Record(Stage, GetTimeNanos() - Start); }
+};
+
+// Copies the valid part of a stage ring, oldest first. Returns the sample count.
+static int Profiler_CopySamples(ovrProfileStage stage, uint32_t* out) {
+    uint32_t count = __atomic_load_n(&g_Profiler.Count[stage], __ATOMIC_ACQUIRE);
+    int n = count < PROFILE_RING_SIZE ? (int)count : PROFILE_RING_SIZE;
+    for (int i = 0; i < n; i++) {
+        uint32_t index = (count - n + i) % PROFILE_RING_SIZE;
+        out[i] = __atomic_load_n(&g_Profiler.Samples[stage][index], __ATOMIC_RELAXED);
+    }
+    return n;
+}
 
-    // Main window
-    ImGui::SetNextWindowPos(ImVec2(20, 20), ImGuiCond_Always);
-    ImGui::SetNextWindowSize(ImVec2(UI_WIDTH - 40, UI_HEIGHT - 40), ImGuiCond_Always);
+static int CompareU32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
 
-    ImGui::Begin("Quest 3 Presence Test", NULL,
-                 ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse);
+static void Profiler_UpdateStats() {
+    uint32_t sorted[PROFILE_RING_SIZE];
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        int n = Profiler_CopySamples((ovrProfileStage)stage, sorted);
+        if (n == 0) continue;
+
+        if (stage == PROFILE_STAGE_FRAME) {
+            memset(g_Profiler.FrameHistogram, 0, sizeof(g_Profiler.FrameHistogram));
+            for (int i = 0; i < n; i++) {
+                uint32_t bin = sorted[i] / 1000;
+                if (bin >= PROFILE_HISTOGRAM_BINS) bin = PROFILE_HISTOGRAM_BINS - 1;
+                g_Profiler.FrameHistogram[bin] += 1.0f;
+            }
+        }
 
-    // Title
+        qsort(sorted, n, sizeof(uint32_t), CompareU32);
+        g_Profiler.P50[stage] = sorted[(n - 1) * 50 / 100] / 1000.0f;
+        g_Profiler.P95[stage] = sorted[(n - 1) * 95 / 100] / 1000.0f;
+        g_Profiler.P99[stage] = sorted[(n - 1) * 99 / 100] / 1000.0f;
+    }
+}
+
+// Writes every stage ring to a CSV file, one row per sample (oldest first).
+static void Profiler_DumpCsv() {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_profile_%ld.csv",
+             appState.DataPath ? appState.DataPath : ".", (long)time(NULL));
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        AppendLogError("Profile dump FAILED: cannot open %s", path);
+        return;
+    }
+
+    static uint32_t samples[PROFILE_STAGE_COUNT][PROFILE_RING_SIZE];
+    int counts[PROFILE_STAGE_COUNT];
+    int rows = 0;
+    fprintf(f, "sample");
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        counts[stage] = Profiler_CopySamples((ovrProfileStage)stage, samples[stage]);
+        if (counts[stage] > rows) rows = counts[stage];
+        fprintf(f, ",%s_us", PROFILE_STAGE_NAMES[stage]);
+    }
+    fprintf(f, "\n");
+
+    // Rows are aligned on the newest sample of every stage
+    for (int row = 0; row < rows; row++) {
+        fprintf(f, "%d", row);
+        for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+            int index = row - (rows - counts[stage]);
+            if (index >= 0) {
+                fprintf(f, ",%u", samples[stage][index]);
+            } else {
+                fprintf(f, ",");
+            }
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    AppendLog("Frame profile written: %s (%d rows)", path, rows);
+}
+
+static void DrawProfilerSection() {
+    if (!ImGui::CollapsingHeader("Frame Timing")) {
+        return;
+    }
+
+    uint64_t now = GetTimeNanos();
+    if (now - g_Profiler.LastStatsTime >= PROFILE_STATS_INTERVAL_NS) {
+        Profiler_UpdateStats();
+        g_Profiler.LastStatsTime = now;
+    }
+
+    if (ImGui::BeginTable("ProfileStages", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Stage");
+        ImGui::TableSetupColumn("p50 ms");
+        ImGui::TableSetupColumn("p95 ms");
+        ImGui::TableSetupColumn("p99 ms");
+        ImGui::TableHeadersRow();
+        for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(PROFILE_STAGE_NAMES[stage]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", g_Profiler.P50[stage]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", g_Profiler.P95[stage]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", g_Profiler.P99[stage]);
+        }
+        ImGui::EndTable();
+    }
+
+    if (g_Profiler.IdleWallNs > 0) {
+        ImGui::Text("Idle: %.2f%% of a core over %.1f s",
+                    100.0 * (double)g_Profiler.IdleCpuNs / (double)g_Profiler.IdleWallNs,
+                    g_Profiler.IdleWallNs / 1e9);
+    }
+
+    ImGui::PlotHistogram("##FrameHistogram", g_Profiler.FrameHistogram, PROFILE_HISTOGRAM_BINS,
+                         0, "Frame time, 0-40 ms", 0.0f, FLT_MAX, ImVec2(0, 120));
+
+    if (ImGui::Button("Dump CSV", ImVec2(200, 60))) {
+        Profiler_DumpCsv();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Trace", ImVec2(200, 60))) {
+        Spans_ExportJson();
+    }
+}
+
+// ================================================================================
+// Panel Atlas
+// ================================================================================
+// All panels share one swapchain. Their regions are shelf-packed into it once at
+// startup, the whole atlas is rendered in a single pass, and each region is shown
+// through its own quad layer via subImage.imageRect. Swapchain work therefore
+// stays at one acquire/wait/release per frame however many panels there are.
+#define PANEL_PIXELS_PER_METER 640.0f
+#define PANEL_DISTANCE 2.0f     // Radius of the arc the panels sit on
+#define ATLAS_MAX_WIDTH 2560
+#define ATLAS_PADDING 8         // Gutter so texture filtering never reaches a neighbour
+
+typedef struct {
+    const char* Title;
+    int Width;          // Logical UI pixels
+    int Height;
+    float Azimuth;      // Radians around the user, positive to the right
+    float Elevation;    // Height of the panel center in meters
+    bool Static;        // Rarely changes: own static swapchain instead of an atlas region
+    int AtlasX;         // Top-left in logical canvas pixels, set by Atlas_Pack
+    int AtlasY;
+} ovrPanel;
+
+static ovrPanel g_Panels[PANEL_COUNT] = {
+    {"Quest 3 Presence Test", 1024, 440, 0.0f, 0.63f, false},
+    {"Controls", 1024, 560, 0.0f, -0.2f, false},
+    {"Log", 1024, 720, 0.82f, 0.0f, false},
+    {"Diagnostics", 1024, 900, -0.82f, 0.0f, false},
+    {"Invite Friends", 1024, 720, 1.64f, 0.0f, false},
+    {"Instructions", 1024, 380, 0.0f, -0.99f, true},
+};
+
+// ImGui lays every panel out on one logical canvas: the atlas panels on top,
+// static panels below them. Only the top part is backed by the atlas swapchain.
+typedef struct {
+    int Width;          // Logical size of the packed atlas
+    int Height;
+    int CanvasWidth;
+    int CanvasHeight;
+} ovrPanelAtlas;
+
+static ovrPanelAtlas g_Atlas;
+
+// Shelf packer: tallest panels first, left to right, starting a new shelf when
+// the current one is full.
+static void Atlas_PackShelves(bool staticPanels, int originY, int* outWidth, int* outHeight) {
+    int order[PANEL_COUNT];
+    int count = 0;
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        if (g_Panels[i].Static != staticPanels) continue;
+        int j = count++;
+        while (j > 0 && g_Panels[order[j - 1]].Height < g_Panels[i].Height) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    int x = 0;
+    int y = originY;
+    int shelfHeight = 0;
+    *outWidth = 0;
+    *outHeight = originY;
+    for (int n = 0; n < count; n++) {
+        ovrPanel* panel = &g_Panels[order[n]];
+        if (x > 0 && x + panel->Width > ATLAS_MAX_WIDTH) {
+            y += shelfHeight + ATLAS_PADDING;
+            x = 0;
+            shelfHeight = 0;
+        }
+        panel->AtlasX = x;
+        panel->AtlasY = y;
+        x += panel->Width + ATLAS_PADDING;
+        if (panel->Height > shelfHeight) shelfHeight = panel->Height;
+        if (panel->AtlasX + panel->Width > *outWidth) *outWidth = panel->AtlasX + panel->Width;
+        if (y + panel->Height > *outHeight) *outHeight = y + panel->Height;
+    }
+}
+
+static void Atlas_Pack() {
+    Atlas_PackShelves(false, 0, &g_Atlas.Width, &g_Atlas.Height);
+
+    int staticWidth;
+    Atlas_PackShelves(true, g_Atlas.Height + ATLAS_PADDING, &staticWidth, &g_Atlas.CanvasHeight);
+    g_Atlas.CanvasWidth = staticWidth > g_Atlas.Width ? staticWidth : g_Atlas.Width;
+    if (g_Atlas.CanvasHeight == g_Atlas.Height + ATLAS_PADDING) {
+        g_Atlas.CanvasHeight = g_Atlas.Height;  // No static panels
+    }
+
+    LOGI(RENDER, "Panel atlas: %dx%d, canvas %dx%d", g_Atlas.Width, g_Atlas.Height,
+          g_Atlas.CanvasWidth, g_Atlas.CanvasHeight);
+}
+
+// Region of a panel in an atlas rendered at the given scale. ImGui lays the atlas
+// out top-down while GL images have a bottom-left origin, hence the flip.
+static XrRect2Di GetPanelImageRect(const ovrPanel* panel, float scale) {
+    const int32_t atlasHeight = (int32_t)(g_Atlas.Height * scale);
+    XrRect2Di rect;
+    rect.offset.x = (int32_t)(panel->AtlasX * scale);
+    rect.offset.y = atlasHeight - (int32_t)((panel->AtlasY + panel->Height) * scale);
+    rect.extent.width = (int32_t)(panel->Width * scale);
+    rect.extent.height = (int32_t)(panel->Height * scale);
+    return rect;
+}
+
+// Builds the quad layers once; afterwards only their image rects change, plus
+// the swapchain of static panels when they are re-created.
+static void Atlas_InitLayers() {
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        const ovrPanel* panel = &g_Panels[i];
+        XrCompositionLayerQuad* layer = &appState.PanelLayers[i];
+        layer->type = XR_TYPE_COMPOSITION_LAYER_QUAD;
+        layer->layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
+        layer->space = appState.LocalSpace;
+        layer->eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+        if (!panel->Static) {
+            layer->subImage.swapchain = appState.UiSwapChain.Handle;
+            layer->subImage.imageRect = GetPanelImageRect(panel, 1.0f);
+        }
+        layer->subImage.imageArrayIndex = 0;
+
+        // Panels sit on an arc around the user, each turned to face the origin
+        layer->pose.orientation.x = 0.0f;
+        layer->pose.orientation.y = sinf(-panel->Azimuth * 0.5f);
+        layer->pose.orientation.z = 0.0f;
+        layer->pose.orientation.w = cosf(-panel->Azimuth * 0.5f);
+        layer->pose.position.x = PANEL_DISTANCE * sinf(panel->Azimuth);
+        layer->pose.position.y = panel->Elevation;
+        layer->pose.position.z = -PANEL_DISTANCE * cosf(panel->Azimuth);
+        layer->size.width = panel->Width / PANEL_PIXELS_PER_METER;
+        layer->size.height = panel->Height / PANEL_PIXELS_PER_METER;
+    }
+}
+
+// ================================================================================
+// Adaptive Panel Resolution
+// ================================================================================
+// The atlas swapchain is allocated at full size. Under load the panels are
+// rendered into a smaller region of it (imageRect) by lowering ImGui's
+// framebuffer scale; layout and cursor coordinates stay in logical UI units, so
+// only sharpness changes. Hysteresis keeps the level from oscillating.
+static const float PANEL_SCALE_LEVELS[] = {1.0f, 0.875f, 0.75f, 0.625f, 0.5f};
+static const int PANEL_SCALE_LEVEL_COUNT = sizeof(PANEL_SCALE_LEVELS) / sizeof(PANEL_SCALE_LEVELS[0]);
+
+static const float PANEL_LOAD_HIGH = 0.85f;     // Fraction of the display period
+static const float PANEL_LOAD_LOW = 0.60f;
+static const int PANEL_DOWNSCALE_FRAMES = 15;   // Sustained overload before shrinking
+static const int PANEL_UPSCALE_FRAMES = 180;    // Sustained headroom before growing
+static const int PANEL_SCALE_COOLDOWN = 90;     // Frames to settle after a change
+
+static float GetPanelScale() {
+    return PANEL_SCALE_LEVELS[appState.PanelScaleLevel];
+}
+
+// Pixel size of the region the atlas rendered at the given scale occupies. Matches
+// the framebuffer size imgui_impl_opengl3 derives from the draw data.
+static XrExtent2Di GetAtlasExtent(float scale) {
+    XrExtent2Di extent = {(int32_t)(g_Atlas.Width * scale), (int32_t)(g_Atlas.Height * scale)};
+    return extent;
+}
+
+// GPU timing through EXT_disjoint_timer_query. Queries are read back a few
+// frames later, only once available, so the render path never stalls on them.
+#define GPU_TIMER_QUERIES 4
+
+typedef struct {
+    bool Supported;
+    GLuint Queries[GPU_TIMER_QUERIES];
+    uint32_t WriteIndex;
+    uint32_t ReadIndex;
+    bool Active;
+    PFNGLGETQUERYOBJECTUI64VEXTPROC GetQueryObjectui64v;
+} ovrGpuTimer;
+
+static ovrGpuTimer g_GpuTimer;
+
+static void GpuTimer_Init() {
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    g_GpuTimer.GetQueryObjectui64v =
+        (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress("glGetQueryObjectui64vEXT");
+    g_GpuTimer.Supported = extensions && strstr(extensions, "GL_EXT_disjoint_timer_query") &&
+                           g_GpuTimer.GetQueryObjectui64v;
+    if (g_GpuTimer.Supported) {
+        glGenQueries(GPU_TIMER_QUERIES, g_GpuTimer.Queries);
+    }
+    LOGI(RENDER, "GPU timer queries %s", g_GpuTimer.Supported ? "enabled" : "not supported");
+}
+
+static void GpuTimer_Shutdown() {
+    if (g_GpuTimer.Supported) {
+        glDeleteQueries(GPU_TIMER_QUERIES, g_GpuTimer.Queries);
+    }
+    memset(&g_GpuTimer, 0, sizeof(g_GpuTimer));
+}
+
+static void GpuTimer_Collect() {
+    while (g_GpuTimer.ReadIndex != g_GpuTimer.WriteIndex) {
+        GLuint query = g_GpuTimer.Queries[g_GpuTimer.ReadIndex % GPU_TIMER_QUERIES];
+        GLuint available = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 elapsed = 0;
+        g_GpuTimer.GetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        g_GpuTimer.ReadIndex++;
+
+        // A disjoint event (e.g. GPU frequency change) invalidates the result
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        if (!disjoint) {
+            Profiler_Record(PROFILE_STAGE_GPU_UI, elapsed);
+            __atomic_store_n(&appState.GpuPanelTimeNs, (uint64_t)elapsed, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void GpuTimer_Begin() {
+    if (!g_GpuTimer.Supported) return;
+    GpuTimer_Collect();
+    g_GpuTimer.Active = g_GpuTimer.WriteIndex - g_GpuTimer.ReadIndex < GPU_TIMER_QUERIES;
+    if (g_GpuTimer.Active) {
+        glBeginQuery(GL_TIME_ELAPSED_EXT, g_GpuTimer.Queries[g_GpuTimer.WriteIndex % GPU_TIMER_QUERIES]);
+    }
+}
+
+static void GpuTimer_End() {
+    if (!g_GpuTimer.Active) return;
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+    g_GpuTimer.WriteIndex++;
+    g_GpuTimer.Active = false;
+}
+
+// Called once per submitted frame on the main thread with the CPU time the frame
+// took outside xrWaitFrame.
+static void AdaptivePanel_Update(uint64_t cpuWorkNs, XrDuration displayPeriod) {
+    if (!appState.AdaptiveResolution || displayPeriod <= 0) return;
+
+    // A GPU sample counts once, for the render it measured. Skipped frames
+    // render nothing, so they are judged on CPU time alone.
+    uint64_t gpuNs = __atomic_exchange_n(&appState.GpuPanelTimeNs, 0, __ATOMIC_RELAXED);
+    uint64_t worstNs = cpuWorkNs > gpuNs ? cpuWorkNs : gpuNs;
+    float load = (float)worstNs / (float)displayPeriod;
+    appState.PanelLoad = appState.PanelLoad * 0.9f + load * 0.1f;
+
+    if (appState.ScaleCooldownFrames > 0) {
+        appState.ScaleCooldownFrames--;
+        return;
+    }
+
+    if (appState.PanelLoad > PANEL_LOAD_HIGH) {
+        appState.OverBudgetFrames++;
+        appState.UnderBudgetFrames = 0;
+    } else if (appState.PanelLoad < PANEL_LOAD_LOW) {
+        appState.UnderBudgetFrames++;
+        appState.OverBudgetFrames = 0;
+    } else {
+        appState.OverBudgetFrames = 0;
+        appState.UnderBudgetFrames = 0;
+    }
+
+    int level = appState.PanelScaleLevel;
+    if (appState.OverBudgetFrames >= PANEL_DOWNSCALE_FRAMES && level < PANEL_SCALE_LEVEL_COUNT - 1) {
+        level++;
+    } else if (appState.UnderBudgetFrames >= PANEL_UPSCALE_FRAMES && level > 0) {
+        level--;
+    }
+
+    if (level != appState.PanelScaleLevel) {
+        LOGI(RENDER, "Panel scale %.3f -> %.3f (load %.2f)", GetPanelScale(), PANEL_SCALE_LEVELS[level],
+              appState.PanelLoad);
+        appState.PanelScaleLevel = level;
+        appState.OverBudgetFrames = 0;
+        appState.UnderBudgetFrames = 0;
+        appState.ScaleCooldownFrames = PANEL_SCALE_COOLDOWN;
+    }
+}
+
+// ================================================================================
+// Platform Request Tracker
+// ================================================================================
+// Every issued ovrRequest is remembered with its issue time until the response
+// with the same ID is popped. Per API (response message type) the tracker keeps
+// success/error counts, a latency histogram and the most recent latencies for
+// percentiles, and flags requests still pending after REQUEST_STUCK_NS.
+// It also measures time-to-joinable: from the first presence request of a join
+// flow (and from launch) to the GroupPresence_Set ack that makes us joinable.
+#define REQUEST_TABLE_SIZE 256                      // In-flight requests, power of two
+#define REQUEST_LATENCY_SAMPLES 128
+static const uint64_t REQUEST_STUCK_NS = 10000000000ull;
+static const uint64_t REQUEST_STUCK_CHECK_NS = 1000000000ull;
+
+// Histogram bucket upper bounds; one more bucket collects everything slower
+static const uint32_t REQUEST_BUCKET_MS[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+#define REQUEST_BUCKET_COUNT (int)(sizeof(REQUEST_BUCKET_MS) / sizeof(REQUEST_BUCKET_MS[0]) + 1)
+
+typedef struct {
+    ovrRequest Id;          // 0 = free slot
+    uint64_t IssueNs;
+    int16_t TypeIndex;      // Into MESSAGE_TYPES
+    bool Stuck;
+} ovrPendingRequest;
+
+typedef struct {
+    uint64_t Issued;
+    uint64_t Succeeded;
+    uint64_t Failed;
+    uint64_t Stuck;         // Requests that crossed REQUEST_STUCK_NS, completed or not
+    uint32_t Pending;
+    uint64_t MaxNs;
+    uint64_t SumNs;
+    uint32_t Buckets[REQUEST_BUCKET_COUNT];
+    uint32_t SamplesUs[REQUEST_LATENCY_SAMPLES];    // Ring of recent latencies
+    uint32_t SampleCount;
+} ovrRequestStats;
+
+typedef struct {
+    ovrPendingRequest Pending[REQUEST_TABLE_SIZE];
+    uint32_t PendingCount;
+    uint64_t Untracked;         // Issued while the table was full
+    uint64_t NextStuckCheckNs;
+    ovrRequestStats Stats[MESSAGE_TYPE_COUNT];
+
+    uint64_t LaunchNs;
+    uint64_t JoinFlowStartNs;   // 0 when no join flow is in progress
+    uint64_t LastTimeToJoinableNs;
+    uint64_t LaunchToJoinableNs;
+} ovrRequestTracker;
+
+static ovrRequestTracker g_Requests;
+
+static uint32_t RequestSlot(ovrRequest id) {
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 56) & (REQUEST_TABLE_SIZE - 1);
+}
+
+static void RequestTracker_Issue(ovrMessageType type, ovrRequest id, uint64_t now) {
+    int index = MessageTypeIndex(type);
+    if (id == 0 || index < 0) return;
+    ovrRequestStats* stats = &g_Requests.Stats[index];
+    stats->Issued++;
+    if (g_Requests.PendingCount >= REQUEST_TABLE_SIZE - 1) {
+        g_Requests.Untracked++;
+        return;
+    }
+    uint32_t slot = RequestSlot(id);
+    while (g_Requests.Pending[slot].Id != 0) slot = (slot + 1) & (REQUEST_TABLE_SIZE - 1);
+    g_Requests.Pending[slot] = {id, now, (int16_t)index, false};
+    g_Requests.PendingCount++;
+    stats->Pending++;
+}
+
+// Removes a pending request, keeping every probe chain intact (backward shift).
+static void RequestTracker_Remove(uint32_t slot) {
+    const uint32_t mask = REQUEST_TABLE_SIZE - 1;
+    uint32_t hole = slot;
+    for (uint32_t next = (hole + 1) & mask; g_Requests.Pending[next].Id != 0; next = (next + 1) & mask) {
+        uint32_t home = RequestSlot(g_Requests.Pending[next].Id);
+        // Move the entry back unless its home lies cyclically in (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            g_Requests.Pending[hole] = g_Requests.Pending[next];
+            hole = next;
+        }
+    }
+    g_Requests.Pending[hole].Id = 0;
+    g_Requests.PendingCount--;
+}
+
+static void RequestTracker_Complete(ovrRequest id, bool isError, uint64_t now) {
+    uint32_t slot = RequestSlot(id);
+    while (g_Requests.Pending[slot].Id != id) {
+        if (g_Requests.Pending[slot].Id == 0) return;   // Not ours, or untracked
+        slot = (slot + 1) & (REQUEST_TABLE_SIZE - 1);
+    }
+    const ovrPendingRequest* request = &g_Requests.Pending[slot];
+    ovrRequestStats* stats = &g_Requests.Stats[request->TypeIndex];
+    uint64_t latencyNs = now - request->IssueNs;
+    if (request->Stuck) {
+        LOGW(PLATFORM, "%s request %llu completed after %.1f s", MESSAGE_TYPE_NAMES[request->TypeIndex],
+             (unsigned long long)id, latencyNs / 1e9);
+    }
+
+    if (isError) {
+        stats->Failed++;
+    } else {
+        stats->Succeeded++;
+    }
+    stats->Pending--;
+    stats->SumNs += latencyNs;
+    if (latencyNs > stats->MaxNs) stats->MaxNs = latencyNs;
+    int bucket = 0;
+    while (bucket < REQUEST_BUCKET_COUNT - 1 && latencyNs > REQUEST_BUCKET_MS[bucket] * 1000000ull) bucket++;
+    stats->Buckets[bucket]++;
+    uint64_t latencyUs = latencyNs / 1000;
+    stats->SamplesUs[stats->SampleCount++ % REQUEST_LATENCY_SAMPLES] =
+        latencyUs > UINT32_MAX ? UINT32_MAX : (uint32_t)latencyUs;
+
+    RequestTracker_Remove(slot);
+}
+
+// Flags requests pending for longer than REQUEST_STUCK_NS, once each.
+static void RequestTracker_CheckStuck(uint64_t now) {
+    if (now < g_Requests.NextStuckCheckNs || g_Requests.PendingCount == 0) return;
+    g_Requests.NextStuckCheckNs = now + REQUEST_STUCK_CHECK_NS;
+    for (int i = 0; i < REQUEST_TABLE_SIZE; i++) {
+        ovrPendingRequest* request = &g_Requests.Pending[i];
+        if (request->Id == 0 || request->Stuck || now - request->IssueNs < REQUEST_STUCK_NS) continue;
+        request->Stuck = true;
+        g_Requests.Stats[request->TypeIndex].Stuck++;
+        AppendLogWarn("%s request %llu has no response after %.0f s",
+                      MESSAGE_TYPE_NAMES[request->TypeIndex], (unsigned long long)request->Id,
+                      (now - request->IssueNs) / 1e9);
+    }
+}
+
+// Latency percentile over the recent samples, in milliseconds (0 without samples).
+static float RequestStats_Percentile(const ovrRequestStats* stats, int percent) {
+    uint32_t sorted[REQUEST_LATENCY_SAMPLES];
+    uint32_t n = stats->SampleCount < REQUEST_LATENCY_SAMPLES ? stats->SampleCount : REQUEST_LATENCY_SAMPLES;
+    if (n == 0) return 0.0f;
+    memcpy(sorted, stats->SamplesUs, n * sizeof(uint32_t));
+    qsort(sorted, n, sizeof(uint32_t), CompareU32);
+    return sorted[(n - 1) * percent / 100] / 1000.0f;
+}
+
+// A presence request that should end with us joinable. Starts the clock if no
+// join flow is already running, so retries count towards the same flow.
+static void RequestTracker_JoinFlowStart(uint64_t now) {
+    if (g_Requests.JoinFlowStartNs == 0) g_Requests.JoinFlowStartNs = now;
+}
+
+static void RequestTracker_Joinable(uint64_t now) {
+    if (g_Requests.JoinFlowStartNs != 0) {
+        g_Requests.LastTimeToJoinableNs = now - g_Requests.JoinFlowStartNs;
+        g_Requests.JoinFlowStartNs = 0;
+        AppendLog("Time to joinable: %.1f ms", g_Requests.LastTimeToJoinableNs / 1e6);
+    }
+    if (g_Requests.LaunchToJoinableNs == 0) {
+        g_Requests.LaunchToJoinableNs = now - g_Requests.LaunchNs;
+        AppendLog("Joinable %.2f s after launch", g_Requests.LaunchToJoinableNs / 1e9);
+    }
+}
+
+// Records an issued Platform request in the tracker, the event trace and the span trace.
+static void TrackPlatformRequest(ovrMessageType type, ovrRequest request) {
+    RequestTracker_Issue(type, request, GetTimeNanos());
+    Trace_Emit(TRACE_EVENT_PLATFORM_REQUEST, (uint32_t)type, 0, request, 0);
+    Spans_AsyncBegin(MessageTypeName(type), request);
+}
+
+// Writes per-API request statistics to a CSV file.
+static void RequestTracker_DumpCsv() {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/platform_requests_%ld.csv",
+             appState.DataPath ? appState.DataPath : ".", (long)time(NULL));
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        AppendLogError("Request dump FAILED: cannot open %s", path);
+        return;
+    }
+
+    fprintf(f, "api,issued,succeeded,failed,pending,stuck,mean_ms,p50_ms,p95_ms,max_ms");
+    for (int bucket = 0; bucket < REQUEST_BUCKET_COUNT - 1; bucket++) {
+        fprintf(f, ",le_%ums", REQUEST_BUCKET_MS[bucket]);
+    }
+    fprintf(f, ",gt_%ums\n", REQUEST_BUCKET_MS[REQUEST_BUCKET_COUNT - 2]);
+    int rows = 0;
+    for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+        const ovrRequestStats* stats = &g_Requests.Stats[i];
+        if (stats->Issued == 0) continue;
+        uint64_t completed = stats->Succeeded + stats->Failed;
+        fprintf(f, "%s,%llu,%llu,%llu,%u,%llu,%.3f,%.3f,%.3f,%.3f", MESSAGE_TYPE_NAMES[i],
+                (unsigned long long)stats->Issued, (unsigned long long)stats->Succeeded,
+                (unsigned long long)stats->Failed, stats->Pending, (unsigned long long)stats->Stuck,
+                completed ? stats->SumNs / 1e6 / completed : 0.0,
+                RequestStats_Percentile(stats, 50), RequestStats_Percentile(stats, 95), stats->MaxNs / 1e6);
+        for (int bucket = 0; bucket < REQUEST_BUCKET_COUNT; bucket++) {
+            fprintf(f, ",%u", stats->Buckets[bucket]);
+        }
+        fprintf(f, "\n");
+        rows++;
+    }
+    fprintf(f, "# time_to_joinable_ms,%.3f\n# launch_to_joinable_ms,%.3f\n",
+            g_Requests.LastTimeToJoinableNs / 1e6, g_Requests.LaunchToJoinableNs / 1e6);
+    fclose(f);
+    AppendLog("Request stats written: %s (%d APIs)", path, rows);
+}
+
+static void DrawRequestSection() {
+    if (!ImGui::CollapsingHeader("Platform Requests")) {
+        return;
+    }
+
+    if (g_Requests.LastTimeToJoinableNs > 0) {
+        ImGui::Text("Time to joinable: %.1f ms (launch to joinable %.2f s)",
+                    g_Requests.LastTimeToJoinableNs / 1e6, g_Requests.LaunchToJoinableNs / 1e9);
+    } else {
+        ImGui::Text("Time to joinable: %s", g_Requests.JoinFlowStartNs ? "waiting for ack" : "not measured yet");
+    }
+
+    if (ImGui::BeginTable("Requests", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("API", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("OK");
+        ImGui::TableSetupColumn("Err");
+        ImGui::TableSetupColumn("Pending");
+        ImGui::TableSetupColumn("p50 ms");
+        ImGui::TableSetupColumn("p95 ms");
+        ImGui::TableSetupColumn("max ms");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+            const ovrRequestStats* stats = &g_Requests.Stats[i];
+            if (stats->Issued == 0) continue;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(MESSAGE_TYPE_NAMES[i]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)stats->Succeeded);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)stats->Failed);
+            ImGui::TableNextColumn();
+            if (stats->Stuck > 0) {
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%u (%llu stuck)", stats->Pending,
+                                   (unsigned long long)stats->Stuck);
+            } else {
+                ImGui::Text("%u", stats->Pending);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", RequestStats_Percentile(stats, 50));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", RequestStats_Percentile(stats, 95));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", stats->MaxNs / 1e6);
+        }
+        ImGui::EndTable();
+    }
+
+    if (g_Requests.Untracked > 0) {
+        ImGui::Text("Untracked (table full): %llu", (unsigned long long)g_Requests.Untracked);
+    }
+
+    if (ImGui::Button("Export Requests", ImVec2(260, 60))) {
+        RequestTracker_DumpCsv();
+    }
+}
+
+// ================================================================================
+// Request Awaiting
+// ================================================================================
+// Presence flows are C++20 coroutines on the main thread:
+//
+//     ovrRequestResult result = co_await AwaitRequest(LaunchInvitePanel());
+//
+// suspends until the pump pops the response with that ovrRequest ID, the
+// timeout passes, or the flow is cancelled, and resumes right there in the pump,
+// so the next request goes out in the same frame the response arrived. Frames
+// keep running while a flow waits. Responses still reach the registered handlers
+// first, so app state is up to date when a flow resumes.
+#define REQUEST_AWAIT_SLOTS 16
+static const uint64_t REQUEST_AWAIT_DEFAULT_TIMEOUT_NS = 10000000000ull;
+
+typedef enum {
+    REQUEST_STATUS_OK,
+    REQUEST_STATUS_ERROR,       // Error response, or the request was never issued
+    REQUEST_STATUS_TIMEOUT,
+    REQUEST_STATUS_CANCELLED,
+} ovrRequestStatus;
+
+static const char* const REQUEST_STATUS_NAMES[] = {"ok", "error", "timed out", "cancelled"};
+
+typedef struct {
+    ovrRequestStatus Status;
+    int ErrorCode;
+    char ErrorMessage[128];
+    bool Ok() const { return Status == REQUEST_STATUS_OK; }
+} ovrRequestResult;
+
+typedef struct {
+    ovrRequest Id;              // 0 when waiting on a presence generation
+    uint64_t PresenceGeneration;
+    uint64_t DeadlineNs;        // 0 = no timeout
+    std::coroutine_handle<> Handle;     // Null = free slot
+    ovrRequestResult* Result;   // In the suspended awaiter
+} ovrRequestAwait;
+
+typedef struct {
+    ovrRequestAwait Slots[REQUEST_AWAIT_SLOTS];
+    int FlowsRunning;
+} ovrRequestAwaits;
+
+static ovrRequestAwaits g_Awaits;
+
+// Fire-and-forget coroutine: runs eagerly until its first co_await and frees
+// itself when it finishes.
+struct ovrFlow {
+    struct promise_type {
+        promise_type() { g_Awaits.FlowsRunning++; }
+        ~promise_type() { g_Awaits.FlowsRunning--; }
+        ovrFlow get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { abort(); }
+    };
+};
+
+// Waits on one of Id or PresenceGeneration.
+struct ovrRequestAwaiter {
+    ovrRequest Id;
+    uint64_t PresenceGeneration;
+    uint64_t TimeoutNs;
+    bool Done;                  // Already satisfied, Result is set
+    ovrRequestResult Result;
+
+    bool await_ready() {
+        if (Done) return true;
+        if (Id != 0 || PresenceGeneration != 0) return false;
+        Result = {REQUEST_STATUS_ERROR, 0, "request not issued"};
+        return true;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        for (int i = 0; i < REQUEST_AWAIT_SLOTS; i++) {
+            ovrRequestAwait* slot = &g_Awaits.Slots[i];
+            if (slot->Handle) continue;
+            slot->Id = Id;
+            slot->PresenceGeneration = PresenceGeneration;
+            slot->DeadlineNs = TimeoutNs ? GetTimeNanos() + TimeoutNs : 0;
+            slot->Handle = handle;
+            slot->Result = &Result;
+            return true;
+        }
+        Result = {REQUEST_STATUS_ERROR, 0, "too many awaited requests"};
+        return false;   // Resume immediately
+    }
+
+    ovrRequestResult await_resume() { return Result; }
+};
+
+// timeoutNs 0 waits for as long as it takes (until cancelled).
+static ovrRequestAwaiter AwaitRequest(ovrRequest id, uint64_t timeoutNs = REQUEST_AWAIT_DEFAULT_TIMEOUT_NS) {
+    return {id, 0, timeoutNs, false, {}};
+}
+
+// Frees the slot before resuming, since the flow may await again right away.
+static void RequestAwaits_Resume(ovrRequestAwait* slot, const ovrRequestResult& result) {
+    std::coroutine_handle<> handle = slot->Handle;
+    *slot->Result = result;
+    slot->Handle = nullptr;
+    handle.resume();
+}
+
+// Resumes every flow waiting on this request. The message is still valid.
+static void RequestAwaits_Complete(ovrRequest id, ovrMessageHandle message) {
+    for (int i = 0; i < REQUEST_AWAIT_SLOTS; i++) {
+        ovrRequestAwait* slot = &g_Awaits.Slots[i];
+        if (!slot->Handle || slot->Id != id) continue;
+        ovrRequestResult result = {REQUEST_STATUS_OK, 0, ""};
+        if (ovr_Message_IsError(message)) {
+            ovrErrorHandle error = ovr_Message_GetError(message);
+            result.Status = REQUEST_STATUS_ERROR;
+            result.ErrorCode = ovr_Error_GetCode(error);
+            snprintf(result.ErrorMessage, sizeof(result.ErrorMessage), "%s", ovr_Error_GetMessage(error));
+        }
+        RequestAwaits_Resume(slot, result);
+    }
+}
+
+static void RequestAwaits_CheckTimeouts(uint64_t now) {
+    for (int i = 0; i < REQUEST_AWAIT_SLOTS; i++) {
+        ovrRequestAwait* slot = &g_Awaits.Slots[i];
+        if (slot->Handle && slot->DeadlineNs != 0 && now >= slot->DeadlineNs) {
+            RequestAwaits_Resume(slot, {REQUEST_STATUS_TIMEOUT, 0, ""});
+        }
+    }
+}
+
+// Resumes every waiting flow with REQUEST_STATUS_CANCELLED. Flows are expected to
+// return on a failed result, so this also frees their coroutine frames.
+static void RequestAwaits_CancelAll() {
+    for (int i = 0; i < REQUEST_AWAIT_SLOTS; i++) {
+        ovrRequestAwait* slot = &g_Awaits.Slots[i];
+        if (slot->Handle) {
+            RequestAwaits_Resume(slot, {REQUEST_STATUS_CANCELLED, 0, ""});
+        }
+    }
+}
+
+// Resumes every flow waiting on presence generation <= generation.
+static void RequestAwaits_CompletePresence(uint64_t generation, const ovrRequestResult& result) {
+    for (int i = 0; i < REQUEST_AWAIT_SLOTS; i++) {
+        ovrRequestAwait* slot = &g_Awaits.Slots[i];
+        if (slot->Handle && slot->PresenceGeneration != 0 && slot->PresenceGeneration <= generation) {
+            RequestAwaits_Resume(slot, result);
+        }
+    }
+}
+
+// ================================================================================
+// Presence Manager
+// ================================================================================
+// Group presence is a single piece of server state, so only its newest value
+// matters. The manager keeps the state the UI last asked for (Desired) and the
+// one the server last confirmed (Acked), with at most one GroupPresence_Set in
+// flight. Updates made while a request is out only change Desired; when the ack
+// arrives one follow-up carries whatever Desired is by then, and the states in
+// between are never sent. Mashing "Set Presence" costs two round trips, not one
+// per press.
+//
+// Every accepted update bumps Generation. Flows wait for their update with
+//
+//     ovrRequestResult result = co_await AwaitPresence(SetGroupPresence());
+//
+// which completes once a state at least that new is acknowledged, fails if the
+// last request carrying it fails, and times out like AwaitRequest.
+typedef struct {
+    bool HasDestination;
+    bool HasLobbyId;
+    bool HasMatchSessionId;
+    bool IsJoinable;
+    char LobbyId[64];
+    char MatchSessionId[64];
+} ovrPresenceState;
+
+typedef struct {
+    ovrPresenceState Desired;
+    ovrPresenceState InFlight;
+    ovrPresenceState Acked;
+    bool HasAcked;
+    bool FollowUp;                  // Desired changed after InFlight went out
+    bool InFlightStale;             // InFlight went out before a clear
+    ovrRequest InFlightId;          // 0 when idle
+    uint64_t Generation;            // Of Desired
+    uint64_t InFlightGeneration;
+    uint64_t AckedGeneration;
+    uint64_t ClearedGeneration;     // Acks of older requests no longer apply
+
+    uint64_t Updates;               // SetGroupPresence calls that reached the manager
+    uint64_t Sent;
+    uint64_t Superseded;            // Queued states replaced before they were sent
+    uint64_t Unchanged;             // Updates that matched the acked state
+} ovrPresenceManager;
+
+static ovrPresenceManager g_Presence;
+
+static bool PresenceState_Equal(const ovrPresenceState* a, const ovrPresenceState* b) {
+    return a->HasDestination == b->HasDestination && a->HasLobbyId == b->HasLobbyId &&
+           a->HasMatchSessionId == b->HasMatchSessionId && a->IsJoinable == b->IsJoinable &&
+           (!a->HasLobbyId || strcmp(a->LobbyId, b->LobbyId) == 0) &&
+           (!a->HasMatchSessionId || strcmp(a->MatchSessionId, b->MatchSessionId) == 0);
+}
+
+static ovrRequestAwaiter AwaitPresence(uint64_t generation,
+                                       uint64_t timeoutNs = REQUEST_AWAIT_DEFAULT_TIMEOUT_NS) {
+    bool done = generation != 0 && generation <= g_Presence.AckedGeneration;
+    return {0, generation, timeoutNs, done, {REQUEST_STATUS_OK, 0, ""}};
+}
+
+// Sends Desired. Only called with nothing in flight.
+static void Presence_Send() {
+    ovrPresenceManager* pm = &g_Presence;
+    const ovrPresenceState* state = &pm->Desired;
+    ovrGroupPresenceOptionsHandle options = ovr_GroupPresenceOptions_Create();
+    if (state->HasDestination) ovr_GroupPresenceOptions_SetDestinationApiName(options, DESTINATION_API_NAME);
+    if (state->HasLobbyId) ovr_GroupPresenceOptions_SetLobbySessionId(options, state->LobbyId);
+    if (state->HasMatchSessionId) ovr_GroupPresenceOptions_SetMatchSessionId(options, state->MatchSessionId);
+    if (state->IsJoinable) ovr_GroupPresenceOptions_SetIsJoinable(options, true);
+
+    ovrRequest req = ovr_GroupPresence_Set(options);
+    TrackPlatformRequest(ovrMessage_GroupPresence_Set, req);
+    LOGI(PLATFORM, "ovr_GroupPresence_Set request: %llu (generation %llu)", (unsigned long long)req,
+         (unsigned long long)pm->Generation);
+    ovr_GroupPresenceOptions_Destroy(options);
+
+    pm->FollowUp = false;
+    if (req == 0) {
+        AppendLogError("GroupPresence_Set was not issued");
+        RequestAwaits_CompletePresence(pm->Generation, {REQUEST_STATUS_ERROR, 0, "request not issued"});
+        return;
+    }
+    pm->InFlight = *state;
+    pm->InFlightStale = false;
+    pm->InFlightId = req;
+    pm->InFlightGeneration = pm->Generation;
+    pm->Sent++;
+}
+
+// Makes state the desired presence. Returns its generation, which is older than
+// the current one when nothing needs to change.
+static uint64_t Presence_Update(const ovrPresenceState* state) {
+    ovrPresenceManager* pm = &g_Presence;
+    pm->Updates++;
+    if (pm->InFlightId == 0 && pm->HasAcked && PresenceState_Equal(state, &pm->Acked)) {
+        pm->Unchanged++;
+        AppendLog("Presence unchanged, nothing to send");
+        return pm->AckedGeneration;
+    }
+    if (pm->InFlightId != 0 && !pm->InFlightStale && PresenceState_Equal(state, &pm->InFlight)) {
+        // Back to what is already in flight: the queued follow-up is moot
+        if (pm->FollowUp) {
+            pm->Superseded++;
+            pm->FollowUp = false;
+        }
+        pm->Desired = *state;
+        pm->Generation++;
+        pm->InFlightGeneration = pm->Generation;
+        return pm->Generation;
+    }
+
+    pm->Desired = *state;
+    pm->Generation++;
+    if (pm->InFlightId == 0) {
+        Presence_Send();
+    } else {
+        if (pm->FollowUp) pm->Superseded++;
+        pm->FollowUp = true;
+        AppendLog("Presence update queued behind request %llu", (unsigned long long)pm->InFlightId);
+    }
+    return pm->Generation;
+}
+
+// GroupPresence_Set response. Applies the acked state, sends the follow-up if
+// one is queued, then resumes the flows waiting on what was acknowledged.
+static void Presence_OnSetResponse(ovrMessageHandle message) {
+    ovrPresenceManager* pm = &g_Presence;
+    if (ovr_Message_GetRequestID(message) != pm->InFlightId) return;
+    pm->InFlightId = 0;
+    uint64_t generation = pm->InFlightGeneration;
+    bool current = generation > pm->ClearedGeneration;
+
+    ovrRequestResult result = {REQUEST_STATUS_OK, 0, ""};
+    if (ovr_Message_IsError(message)) {
+        ovrErrorHandle error = ovr_Message_GetError(message);
+        result.Status = REQUEST_STATUS_ERROR;
+        result.ErrorCode = ovr_Error_GetCode(error);
+        snprintf(result.ErrorMessage, sizeof(result.ErrorMessage), "%s", ovr_Error_GetMessage(error));
+        AppendLogError("GroupPresence_Set FAILED: %s", result.ErrorMessage);
+        if (current) {
+            // The server keeps whatever it had; stop claiming the old ack
+            appState.PresenceSet = false;
+            appState.IsJoinable = false;
+            pm->HasAcked = false;
+        }
+    } else if (current) {
+        pm->Acked = pm->InFlight;
+        pm->HasAcked = true;
+        pm->AckedGeneration = generation;
+        AppendLog("Group presence set successfully!");
+        appState.PresenceSet = true;
+        appState.IsJoinable = pm->Acked.IsJoinable;
+        if (appState.IsJoinable) {
+            RequestTracker_Joinable(GetTimeNanos());
+        }
+        snprintf(appState.StatusText, sizeof(appState.StatusText),
+                 appState.IsJoinable ? "Presence SET - Ready to invite!" : "Presence SET (not joinable)");
+    }
+
+    if (pm->FollowUp) {
+        // Flows waiting on a failed generation ride along with the newer state
+        Presence_Send();
+        if (result.Ok()) RequestAwaits_CompletePresence(generation, result);
+    } else {
+        RequestAwaits_CompletePresence(result.Ok() ? generation : pm->Generation, result);
+    }
+}
+
+// Forgets all presence state after a clear. A Set still in flight is answered
+// normally, but its ack no longer counts, and the same state asked for again
+// goes out as a follow-up after the clear instead of riding on it.
+static void Presence_Reset() {
+    ovrPresenceManager* pm = &g_Presence;
+    pm->Generation++;
+    pm->ClearedGeneration = pm->Generation;
+    pm->FollowUp = false;
+    pm->InFlightStale = pm->InFlightId != 0;
+    pm->HasAcked = false;
+    memset(&pm->Desired, 0, sizeof(pm->Desired));
+}
+
+// ================================================================================
+// Invitable Users
+// ================================================================================
+// The invite list is built from GroupPresence_GetInvitableUsers, which answers
+// one page at a time; User_GetNextUserArrayPage takes the previous page's array,
+// so the newest page message is kept alive until the next one arrives. Pages
+// are fetched ahead of the list's scroll position rather than all up front, so
+// the first rows show as soon as the first page lands and a long friends list
+// costs nothing until it is scrolled. Users are copied into a cache bounded by
+// debug.xrpresence.invitable_cache and indexed by ovrID, which drops users a
+// later page repeats and keeps selections stable while pages stream in.
+#define INVITABLE_DEFAULT_CAPACITY 4096
+#define INVITABLE_PREFETCH_ROWS 100     // Rows kept loaded past the last one drawn
+
+typedef struct {
+    ovrID Id;
+    char DisplayName[64];
+    char OculusId[32];
+    bool Selected;
+} ovrInvitableUser;
+
+typedef struct {
+    ovrInvitableUser* Users;        // Arrival order, Count of Capacity used
+    uint32_t Count;
+    uint32_t Capacity;
+    uint32_t* Slots;                // ovrID hash -> Users index + 1, 0 when empty
+    uint32_t SlotMask;
+    ovrMessageHandle PageMessage;   // Newest page, kept while it has a next one
+    ovrUserArrayHandle Page;
+    ovrRequest PageRequest;         // 0 when idle
+    uint64_t PageRequestNs;
+    bool HasNextPage;
+    bool Failed;                    // Stops prefetching until the next refresh
+    uint32_t VisibleEnd;            // One past the last row drawn
+    uint32_t SelectedCount;
+    uint64_t Version;               // Bumped whenever the list changes
+
+    uint64_t LoadStartNs;
+    uint64_t FirstPageNs;           // Load start to first page
+    uint64_t MaxPageNs;             // Slowest page round trip
+    uint32_t Pages;
+    uint32_t Duplicates;            // Users a later page repeated
+    uint32_t Dropped;               // Users past Capacity
+} ovrInvitableCache;
+
+static ovrInvitableCache g_Invitable;
+
+static void Invitable_Init(uint32_t capacity) {
+    ovrInvitableCache* cache = &g_Invitable;
+    uint32_t slots = 16;
+    while (slots < capacity * 2) slots <<= 1;   // Load factor <= 0.5
+    cache->Users = (ovrInvitableUser*)calloc(capacity, sizeof(ovrInvitableUser));
+    cache->Slots = (uint32_t*)calloc(slots, sizeof(uint32_t));
+    cache->Capacity = capacity;
+    cache->SlotMask = slots - 1;
+}
+
+// Returns the slot holding id, or the empty slot it would go in.
+static uint32_t Invitable_FindSlot(const ovrInvitableCache* cache, ovrID id) {
+    uint32_t slot = (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 32) & cache->SlotMask;
+    while (cache->Slots[slot] != 0 && cache->Users[cache->Slots[slot] - 1].Id != id) {
+        slot = (slot + 1) & cache->SlotMask;
+    }
+    return slot;
+}
+
+static void Invitable_Add(ovrInvitableCache* cache, ovrUserHandle user) {
+    ovrID id = ovr_User_GetID(user);
+    uint32_t slot = Invitable_FindSlot(cache, id);
+    if (cache->Slots[slot] != 0) {
+        cache->Duplicates++;
+        return;
+    }
+    if (cache->Count == cache->Capacity) {
+        cache->Dropped++;
+        return;
+    }
+    ovrInvitableUser* entry = &cache->Users[cache->Count++];
+    entry->Id = id;
+    snprintf(entry->DisplayName, sizeof(entry->DisplayName), "%s", ovr_User_GetDisplayName(user));
+    snprintf(entry->OculusId, sizeof(entry->OculusId), "%s", ovr_User_GetOculusID(user));
+    entry->Selected = false;
+    cache->Slots[slot] = cache->Count;
+}
+
+// Forgets every cached user. A page still in flight is ignored when it lands.
+static void Invitable_Reset() {
+    ovrInvitableCache* cache = &g_Invitable;
+    if (cache->PageMessage) ovr_FreeMessage(cache->PageMessage);
+    cache->PageMessage = NULL;
+    cache->Page = NULL;
+    cache->PageRequest = 0;
+    cache->HasNextPage = false;
+    cache->Failed = false;
+    cache->Count = 0;
+    cache->VisibleEnd = 0;
+    cache->SelectedCount = 0;
+    cache->Pages = 0;
+    cache->Duplicates = 0;
+    cache->Dropped = 0;
+    cache->FirstPageNs = 0;
+    cache->MaxPageNs = 0;
+    if (cache->Slots) memset(cache->Slots, 0, (cache->SlotMask + 1) * sizeof(uint32_t));
+    cache->Version++;
+}
+
+static void Invitable_Destroy() {
+    Invitable_Reset();
+    free(g_Invitable.Users);
+    free(g_Invitable.Slots);
+    memset(&g_Invitable, 0, sizeof(g_Invitable));
+}
+
+// Requests the first page, dropping whatever was loaded.
+static void Invitable_Load() {
+    if (!appState.PlatformInitialized || !g_Invitable.Users) return;
+    Invitable_Reset();
+    ovrInvitableCache* cache = &g_Invitable;
+    ovrInviteOptionsHandle options = ovr_InviteOptions_Create();
+    ovrRequest req = ovr_GroupPresence_GetInvitableUsers(options);
+    ovr_InviteOptions_Destroy(options);
+    TrackPlatformRequest(ovrMessage_GroupPresence_GetInvitableUsers, req);
+    LOGI(PLATFORM, "ovr_GroupPresence_GetInvitableUsers request: %llu", (unsigned long long)req);
+    cache->LoadStartNs = GetTimeNanos();
+    cache->PageRequest = req;
+    cache->PageRequestNs = cache->LoadStartNs;
+}
+
+// Requests the next page once the rows drawn come within
+// INVITABLE_PREFETCH_ROWS of the end of what is loaded.
+static void Invitable_Prefetch() {
+    ovrInvitableCache* cache = &g_Invitable;
+    if (cache->PageRequest != 0 || !cache->HasNextPage || cache->Failed) return;
+    if (cache->Count >= cache->Capacity || cache->Count >= cache->VisibleEnd + INVITABLE_PREFETCH_ROWS) return;
+    ovrRequest req = ovr_User_GetNextUserArrayPage(cache->Page);
+    TrackPlatformRequest(ovrMessage_User_GetNextUserArrayPage, req);
+    LOGV(PLATFORM, "ovr_User_GetNextUserArrayPage request: %llu", (unsigned long long)req);
+    cache->PageRequest = req;
+    cache->PageRequestNs = GetTimeNanos();
+}
+
+// GetInvitableUsers and GetNextUserArrayPage response. Returns true when the
+// cache keeps the message, to page on from; it is freed with the next page.
+static bool Invitable_OnPage(ovrMessageHandle message, ovrUserArrayHandle users) {
+    ovrInvitableCache* cache = &g_Invitable;
+    if (cache->PageRequest == 0 || ovr_Message_GetRequestID(message) != cache->PageRequest) return false;
+    cache->PageRequest = 0;
+    uint64_t now = GetTimeNanos();
+    if (now - cache->PageRequestNs > cache->MaxPageNs) cache->MaxPageNs = now - cache->PageRequestNs;
+    if (ovr_Message_IsError(message) || !users) {
+        cache->Failed = true;
+        cache->Version++;
+        AppendLogError("Loading invitable users FAILED: %s",
+                       ovr_Message_IsError(message) ? ovr_Error_GetMessage(ovr_Message_GetError(message)) : "no page");
+        return false;
+    }
+
+    if (cache->Pages++ == 0) {
+        cache->FirstPageNs = now - cache->LoadStartNs;
+    }
+    size_t size = ovr_UserArray_GetSize(users);
+    for (size_t i = 0; i < size; i++) {
+        ovrUserHandle user = ovr_UserArray_GetElement(users, i);
+        if (user) Invitable_Add(cache, user);
+    }
+    cache->Version++;
+
+    if (cache->PageMessage) ovr_FreeMessage(cache->PageMessage);
+    cache->HasNextPage = ovr_UserArray_HasNextPage(users);
+    cache->PageMessage = cache->HasNextPage ? message : NULL;
+    cache->Page = cache->HasNextPage ? users : NULL;
+    if (!cache->HasNextPage) {
+        AppendLog("Loaded %u invitable users in %u pages", cache->Count, cache->Pages);
+    }
+    Invitable_Prefetch();
+    return cache->HasNextPage;
+}
+
+static void Invitable_ToggleSelected(ovrInvitableUser* user) {
+    user->Selected = !user->Selected;
+    if (user->Selected) {
+        g_Invitable.SelectedCount++;
+    } else {
+        g_Invitable.SelectedCount--;
+    }
+    g_Invitable.Version++;
+}
+
+// ================================================================================
+// Invite Sender
+// ================================================================================
+// Invites any number of users through GroupPresence_SendInvites without the
+// system panel. The IDs are split into batches of debug.xrpresence.invite_batch
+// users. Up to invite_in_flight batches are out at once, and each send takes a
+// token from a bucket holding up to invite_in_flight, so a long list goes out
+// in parallel but under the service's request quota. The bucket refills at up
+// to invite_rate batches per second: a failure empties it and halves the
+// refill rate, and every sent batch wins some of it back, so a quota lower
+// than invite_rate is found rather than hammered. A failed batch is retried
+// after an exponential, jittered backoff, up to INVITE_MAX_ATTEMPTS sends.
+#define INVITE_DEFAULT_BATCH 20
+#define INVITE_DEFAULT_IN_FLIGHT 4
+#define INVITE_DEFAULT_RATE 5                   // Batches per second
+#define INVITE_MIN_RATE 0.5                     // Floor for the halved rate
+#define INVITE_RATE_RECOVERY_BATCHES 20         // Sent batches to regain the full rate from zero
+#define INVITE_MAX_ATTEMPTS 4
+#define INVITE_BACKOFF_BASE_NS 250000000ull     // Doubles with every failed attempt
+#define INVITE_BACKOFF_MAX_NS 8000000000ull
+
+typedef enum {
+    INVITE_BATCH_QUEUED,
+    INVITE_BATCH_IN_FLIGHT,
+    INVITE_BATCH_SENT,
+    INVITE_BATCH_FAILED,
+} ovrInviteBatchState;
+
+typedef struct {
+    uint32_t First;             // Into ovrInviteSender::Ids
+    uint32_t Count;
+    ovrInviteBatchState State;
+    uint32_t Attempts;
+    uint64_t ReadyNs;           // Backoff: not sent before this
+    uint64_t IssuedNs;
+    ovrRequest Request;
+} ovrInviteBatch;
+
+typedef struct {
+    ImVector<ovrID> Ids;                // Current run, in queue order
+    ImVector<ovrInviteBatch> Batches;
+    int FirstOpen;                      // Batches before this one are sent or failed
+    uint32_t BatchSize;
+    int MaxInFlight;
+    int InFlight;
+    double Rate;                        // Batches per second, 0 = unlimited
+    double CurrentRate;                 // Rate after failures, up to Rate
+    double Tokens;
+    uint64_t RefillNs;
+
+    // Current run; a run ends when its last batch is sent or failed
+    uint64_t StartNs;
+    uint64_t LastResultNs;
+    uint32_t UsersSent;                 // In acknowledged batches
+    uint32_t UsersFailed;               // In batches out of attempts
+    uint32_t InvitesReported;           // Invites the results listed
+
+    uint64_t Retries;
+    uint64_t MaxBatchNs;                // Slowest SendInvites round trip
+} ovrInviteSender;
+
+static ovrInviteSender g_InviteSender;
+
+static void InviteSender_Init(uint32_t batchSize, int maxInFlight, int rate) {
+    g_InviteSender.BatchSize = batchSize;
+    g_InviteSender.MaxInFlight = maxInFlight;
+    g_InviteSender.Rate = rate > 0 ? rate : 0;
+    g_InviteSender.CurrentRate = g_InviteSender.Rate;
+}
+
+static bool InviteSender_Busy() {
+    return g_InviteSender.FirstOpen < g_InviteSender.Batches.Size;
+}
+
+// Users per second acknowledged in the current run.
+static double InviteSender_Throughput() {
+    const ovrInviteSender* sender = &g_InviteSender;
+    uint64_t elapsedNs = sender->LastResultNs - sender->StartNs;
+    return sender->LastResultNs > sender->StartNs ? sender->UsersSent / (elapsedNs / 1e9) : 0.0;
+}
+
+static void InviteSender_Fail(ovrInviteBatch* batch, uint64_t now, const char* reason) {
+    ovrInviteSender* sender = &g_InviteSender;
+    sender->Tokens = 0;
+    if (sender->Rate > 0) {
+        sender->CurrentRate = sender->CurrentRate / 2 > INVITE_MIN_RATE ? sender->CurrentRate / 2 : INVITE_MIN_RATE;
+    }
+    if (batch->Attempts < INVITE_MAX_ATTEMPTS) {
+        uint64_t backoffNs = INVITE_BACKOFF_BASE_NS << (batch->Attempts - 1);
+        if (backoffNs > INVITE_BACKOFF_MAX_NS) backoffNs = INVITE_BACKOFF_MAX_NS;
+        backoffNs = backoffNs / 2 + (uint64_t)rand() % (backoffNs / 2 + 1);
+        batch->State = INVITE_BATCH_QUEUED;
+        batch->ReadyNs = now + backoffNs;
+        sender->Retries++;
+        AppendLogWarn("SendInvites batch of %u failed (%s), retry %u in %.0f ms", batch->Count, reason,
+                      batch->Attempts, backoffNs / 1e6);
+    } else {
+        batch->State = INVITE_BATCH_FAILED;
+        sender->UsersFailed += batch->Count;
+        AppendLogError("SendInvites batch of %u FAILED after %u attempts: %s", batch->Count, batch->Attempts,
+                       reason);
+    }
+}
+
+static void InviteSender_Send(ovrInviteBatch* batch, uint64_t now) {
+    ovrInviteSender* sender = &g_InviteSender;
+    sender->Tokens -= 1.0;
+    batch->Attempts++;
+    ovrRequest req = ovr_GroupPresence_SendInvites(&sender->Ids[batch->First], batch->Count);
+    TrackPlatformRequest(ovrMessage_GroupPresence_SendInvites, req);
+    LOGV(PLATFORM, "ovr_GroupPresence_SendInvites request: %llu (%u users)", (unsigned long long)req,
+         batch->Count);
+    if (req == 0) {
+        InviteSender_Fail(batch, now, "request not issued");
+        return;
+    }
+    batch->State = INVITE_BATCH_IN_FLIGHT;
+    batch->Request = req;
+    batch->IssuedNs = now;
+    sender->InFlight++;
+}
+
+// Moves FirstOpen past finished batches and reports the run once they all are.
+static void InviteSender_Advance() {
+    ovrInviteSender* sender = &g_InviteSender;
+    int before = sender->FirstOpen;
+    while (sender->FirstOpen < sender->Batches.Size &&
+           sender->Batches[sender->FirstOpen].State >= INVITE_BATCH_SENT) {
+        sender->FirstOpen++;
+    }
+    if (sender->FirstOpen != before && !InviteSender_Busy()) {
+        AppendLog("Invites done: %u sent, %u failed in %.1f s (%.1f users/s)", sender->UsersSent,
+                  sender->UsersFailed, (sender->LastResultNs - sender->StartNs) / 1e9, InviteSender_Throughput());
+    }
+}
+
+// Sends whatever batches the in-flight limit, the token bucket and their
+// backoff allow. Runs every frame while a run is open.
+static void InviteSender_Update(uint64_t now) {
+    ovrInviteSender* sender = &g_InviteSender;
+    if (!InviteSender_Busy()) return;
+    if (sender->Rate > 0) {
+        sender->Tokens += (now - sender->RefillNs) * sender->CurrentRate / 1e9;
+        if (sender->Tokens > sender->MaxInFlight) sender->Tokens = sender->MaxInFlight;
+    } else {
+        sender->Tokens = sender->MaxInFlight;
+    }
+    sender->RefillNs = now;
+
+    for (int i = sender->FirstOpen; i < sender->Batches.Size; i++) {
+        if (sender->InFlight >= sender->MaxInFlight || sender->Tokens < 1.0) break;
+        ovrInviteBatch* batch = &sender->Batches[i];
+        if (batch->State == INVITE_BATCH_QUEUED && batch->ReadyNs <= now) {
+            InviteSender_Send(batch, now);
+        }
+    }
+    InviteSender_Advance();     // Batches that could not even be issued
+}
+
+// Queues invites for ids, in batches behind any already queued.
+static void InviteSender_Queue(const ovrID* ids, uint32_t count) {
+    ovrInviteSender* sender = &g_InviteSender;
+    if (!appState.PlatformInitialized) {
+        AppendLogError("ERROR: Platform SDK not initialized yet!");
+        return;
+    }
+    if (count == 0) return;
+    uint64_t now = GetTimeNanos();
+    if (!InviteSender_Busy()) {
+        // New run
+        sender->Ids.resize(0);
+        sender->Batches.resize(0);
+        sender->FirstOpen = 0;
+        sender->StartNs = now;
+        sender->LastResultNs = now;
+        sender->UsersSent = 0;
+        sender->UsersFailed = 0;
+        sender->InvitesReported = 0;
+        sender->Tokens = sender->MaxInFlight;
+        sender->RefillNs = now;
+    }
+    uint32_t first = (uint32_t)sender->Ids.Size;
+    sender->Ids.resize(sender->Ids.Size + (int)count);
+    memcpy(&sender->Ids[first], ids, count * sizeof(ovrID));
+    for (uint32_t offset = 0; offset < count; offset += sender->BatchSize) {
+        ovrInviteBatch batch = {};
+        batch.First = first + offset;
+        batch.Count = count - offset < sender->BatchSize ? count - offset : sender->BatchSize;
+        sender->Batches.push_back(batch);
+    }
+    AppendLog("Queued %u invites (%d in this run)", count, sender->Ids.Size);
+    InviteSender_Update(now);
+}
+
+// GroupPresence_SendInvites response.
+static void InviteSender_OnResult(ovrMessageHandle message, ovrSendInvitesResultHandle result) {
+    ovrInviteSender* sender = &g_InviteSender;
+    ovrRequest id = ovr_Message_GetRequestID(message);
+    ovrInviteBatch* batch = NULL;
+    for (int i = sender->FirstOpen; i < sender->Batches.Size && !batch; i++) {
+        ovrInviteBatch* candidate = &sender->Batches[i];
+        if (candidate->State == INVITE_BATCH_IN_FLIGHT && candidate->Request == id) batch = candidate;
+    }
+    if (!batch) return;
+
+    uint64_t now = GetTimeNanos();
+    sender->InFlight--;
+    sender->LastResultNs = now;
+    if (now - batch->IssuedNs > sender->MaxBatchNs) sender->MaxBatchNs = now - batch->IssuedNs;
+    if (ovr_Message_IsError(message)) {
+        InviteSender_Fail(batch, now, ovr_Error_GetMessage(ovr_Message_GetError(message)));
+    } else {
+        batch->State = INVITE_BATCH_SENT;
+        sender->UsersSent += batch->Count;
+        sender->CurrentRate += sender->Rate / INVITE_RATE_RECOVERY_BATCHES;
+        if (sender->CurrentRate > sender->Rate) sender->CurrentRate = sender->Rate;
+        ovrApplicationInviteArrayHandle invites = result ? ovr_SendInvitesResult_GetInvites(result) : NULL;
+        sender->InvitesReported += invites ? (uint32_t)ovr_ApplicationInviteArray_GetSize(invites) : 0;
+    }
+    InviteSender_Advance();
+    InviteSender_Update(now);   // Use the freed slot right away
+}
+
+// ================================================================================
+// Platform SDK Message Pump
+// ================================================================================
+// Handlers are registered per message type with Dispatcher_On<type>() and get
+// the message's typed payload. Lookup is a perfect-hash probe, and every type
+// keeps a received/error count so the heaviest traffic shows up in the
+// Diagnostics panel. The route lookup and payload extraction happen when the
+// message is decoded, which may be on the pump thread (see Platform Pump). The
+// message is freed once its handler returns, unless the handler keeps it.
+typedef void (*ovrGenericHandler)();
+typedef void (*ovrPayloadDecoder)(ovrMessageHandle message, uint64_t* payload);
+typedef void (*ovrMessageThunk)(ovrGenericHandler handler, ovrMessageHandle message, uint64_t payload);
+
+typedef struct {
+    ovrGenericHandler Handler;  // NULL when nothing is registered
+    ovrPayloadDecoder Decode;   // Stores the typed payload in a uint64_t
+    ovrMessageThunk Thunk;      // Casts Handler and the payload back
+    uint64_t Received;
+    uint64_t Errors;
+} ovrMessageRoute;
+
+static ovrMessageRoute g_MessageRoutes[MESSAGE_TYPE_COUNT];
+static uint64_t g_UnknownMessages;  // Types newer than ovr_message_types.h
+static bool g_MessageKept;          // Set by a handler that frees its message itself
+
+template <ovrMessageType T>
+using ovrMessageHandler = void (*)(ovrMessageHandle message, typename ovrMessagePayload<T>::Type payload);
+
+// Register before the pump thread starts; routes are read-only after that.
+template <ovrMessageType T>
+static void Dispatcher_On(ovrMessageHandler<T> handler) {
+    typedef typename ovrMessagePayload<T>::Type Payload;
+    static_assert(sizeof(Payload) <= sizeof(uint64_t) && std::is_trivially_copyable<Payload>::value,
+                  "payload does not fit a pre-decoded event");
+    constexpr int index = MessageTypeIndex(T);
+    static_assert(index >= 0, "message type missing from ovr_message_types.h");
+    g_MessageRoutes[index].Handler = (ovrGenericHandler)handler;
+    g_MessageRoutes[index].Decode = [](ovrMessageHandle message, uint64_t* payload) {
+        Payload value = ovrMessagePayload<T>::Get(message);
+        memcpy(payload, &value, sizeof(value));
+    };
+    g_MessageRoutes[index].Thunk = [](ovrGenericHandler generic, ovrMessageHandle message, uint64_t payload) {
+        Payload value{};
+        memcpy(&value, &payload, sizeof(value));
+        ((ovrMessageHandler<T>)generic)(message, value);
+    };
+}
+
+static ovrFlow TestCorrectFlow();
+static ovrFlow TestSetClearSetFlow();
+
+static void OnPlatformInitialize(ovrMessageHandle message, std::nullptr_t) {
+    bool isError = ovr_Message_IsError(message);
+    LOGI(PLATFORM, "Got Platform init callback! isError=%d", isError);
+    if (isError) {
+        ovrErrorHandle error = ovr_Message_GetError(message);
+        const char* errMsg = ovr_Error_GetMessage(error);
+        LOGE(PLATFORM, "Platform init FAILED: %s", errMsg);
+        AppendLogError("Platform init FAILED: %s", errMsg);
+    } else {
+        LOGI(PLATFORM, "Platform SDK initialized successfully!");
+        AppendLog("Platform SDK initialized successfully!");
+        appState.PlatformInitialized = true;
+        Invitable_Load();
+        if (appState.AutoFlow == 1) {
+            TestCorrectFlow();
+        } else if (appState.AutoFlow == 2) {
+            TestSetClearSetFlow();
+        }
+    }
+}
+
+static void OnGroupPresenceSet(ovrMessageHandle message, std::nullptr_t) {
+    Presence_OnSetResponse(message);
+}
+
+static void OnLaunchInvitePanel(ovrMessageHandle message, ovrInvitePanelResultInfoHandle result) {
+    if (ovr_Message_IsError(message)) {
+        ovrErrorHandle error = ovr_Message_GetError(message);
+        AppendLogError("LaunchInvitePanel FAILED: %s", ovr_Error_GetMessage(error));
+    } else {
+        AppendLog("Invite panel closed (invites sent: %s)",
+                  result && ovr_InvitePanelResultInfo_GetInvitesSent(result) ? "yes" : "no");
+    }
+}
+
+static void OnGroupPresenceClear(ovrMessageHandle message, std::nullptr_t) {
+    if (ovr_Message_IsError(message)) {
+        ovrErrorHandle error = ovr_Message_GetError(message);
+        AppendLogError("GroupPresence_Clear FAILED: %s", ovr_Error_GetMessage(error));
+    } else {
+        AppendLog("Group presence cleared successfully");
+    }
+}
+
+static void OnJoinIntentReceived(ovrMessageHandle message, ovrGroupPresenceJoinIntentHandle intent) {
+    if (!intent) return;
+    AppendLog("Join intent: destination %s, lobby %s, match %s",
+              ovr_GroupPresenceJoinIntent_GetDestinationApiName(intent),
+              ovr_GroupPresenceJoinIntent_GetLobbySessionId(intent),
+              ovr_GroupPresenceJoinIntent_GetMatchSessionId(intent));
+}
+
+static void OnLeaveIntentReceived(ovrMessageHandle message, ovrGroupPresenceLeaveIntentHandle intent) {
+    if (!intent) return;
+    AppendLog("Leave intent: destination %s, lobby %s, match %s",
+              ovr_GroupPresenceLeaveIntent_GetDestinationApiName(intent),
+              ovr_GroupPresenceLeaveIntent_GetLobbySessionId(intent),
+              ovr_GroupPresenceLeaveIntent_GetMatchSessionId(intent));
+}
+
+static void OnInvitationsSent(ovrMessageHandle message, ovrLaunchInvitePanelFlowResultHandle result) {
+    ovrUserArrayHandle users = result ? ovr_LaunchInvitePanelFlowResult_GetInvitedUsers(result) : NULL;
+    AppendLog("Invitations sent to %zu users", users ? ovr_UserArray_GetSize(users) : (size_t)0);
+}
+
+static void OnInvitableUsersPage(ovrMessageHandle message, ovrUserArrayHandle users) {
+    g_MessageKept = Invitable_OnPage(message, users);
+}
+
+static void OnSendInvites(ovrMessageHandle message, ovrSendInvitesResultHandle result) {
+    InviteSender_OnResult(message, result);
+}
+
+static void RegisterPlatformHandlers() {
+    Dispatcher_On<ovrMessage_PlatformInitializeAndroidAsynchronous>(OnPlatformInitialize);
+    Dispatcher_On<ovrMessage_PlatformInitializeWindowsAsynchronous>(OnPlatformInitialize);  // Headless build
+    Dispatcher_On<ovrMessage_GroupPresence_Set>(OnGroupPresenceSet);
+    Dispatcher_On<ovrMessage_GroupPresence_Clear>(OnGroupPresenceClear);
+    Dispatcher_On<ovrMessage_GroupPresence_LaunchInvitePanel>(OnLaunchInvitePanel);
+    Dispatcher_On<ovrMessage_Notification_GroupPresence_JoinIntentReceived>(OnJoinIntentReceived);
+    Dispatcher_On<ovrMessage_Notification_GroupPresence_LeaveIntentReceived>(OnLeaveIntentReceived);
+    Dispatcher_On<ovrMessage_Notification_GroupPresence_InvitationsSent>(OnInvitationsSent);
+    Dispatcher_On<ovrMessage_GroupPresence_GetInvitableUsers>(OnInvitableUsersPage);
+    Dispatcher_On<ovrMessage_User_GetNextUserArrayPage>(OnInvitableUsersPage);
+    Dispatcher_On<ovrMessage_GroupPresence_SendInvites>(OnSendInvites);
+}
+
+// ================================================================================
+// Platform Recorder
+// ================================================================================
+// With debug.xrpresence.record_platform set, every popped Platform message is
+// appended to platform_messages_<time>.xrrec in the data directory: type,
+// request, error, the payload values the handlers read, and when it arrived,
+// both since recording started and within its frame. The headless build's
+// stub Platform SDK plays a recording back (OVRSTUB_REPLAY), which turns a
+// trace from a headset into a repeatable benchmark load. Messages are written
+// by whichever thread pops them; only one ever does.
+typedef struct {
+    FILE* File;
+    uint64_t StartNs;
+    uint64_t FrameStartNs;      // Set by the frame thread; atomic
+    uint32_t Frame;             // Atomic
+    uint64_t Messages;
+} ovrPlatformRecorder;
+
+static ovrPlatformRecorder g_Recorder;
+
+static void Recorder_Open(const char* dir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/platform_messages_%ld.xrrec", dir, (long)time(NULL));
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        LOGE(PLATFORM, "Recording FAILED: cannot open %s", path);
+        return;
+    }
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    ovrRecordingHeader header = {};
+    memcpy(header.Magic, RECORDING_MAGIC, sizeof(header.Magic));
+    header.Version = RECORDING_VERSION;
+    header.HeaderSize = sizeof(header);
+    header.StartRealtimeNs = (uint64_t)realtime.tv_sec * 1000000000ull + (uint64_t)realtime.tv_nsec;
+    fwrite(&header, sizeof(header), 1, f);
+
+    g_Recorder.File = f;
+    g_Recorder.StartNs = GetTimeNanos();
+    g_Recorder.FrameStartNs = g_Recorder.StartNs;
+    LOGI(PLATFORM, "Recording Platform messages to %s", path);
+}
+
+// After the pump thread has stopped.
+static void Recorder_Close() {
+    if (!g_Recorder.File) return;
+    fclose(g_Recorder.File);
+    g_Recorder.File = NULL;
+    LOGI(PLATFORM, "Recorded %llu Platform messages", (unsigned long long)g_Recorder.Messages);
+}
+
+// Frame thread, at the top of every frame. A message popped on the pump thread
+// while this runs may be filed under the neighbouring frame.
+static void Recorder_BeginFrame(uint64_t frameStartNs) {
+    if (!g_Recorder.File) return;
+    __atomic_store_n(&g_Recorder.FrameStartNs, frameStartNs, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&g_Recorder.Frame, 1, __ATOMIC_RELAXED);
+}
+
+static void Recorder_WriteField(ovrRecordingTag tag, const void* data, size_t length) {
+    ovrRecordingField field = {(uint16_t)tag, (uint16_t)length};
+    fwrite(&field, sizeof(field), 1, g_Recorder.File);
+    fwrite(data, 1, length, g_Recorder.File);
+}
+
+static void Recorder_WriteText(ovrRecordingTag tag, const char* text) {
+    if (text && text[0]) {
+        Recorder_WriteField(tag, text, strnlen(text, UINT16_MAX));
+    }
+}
+
+static void Recorder_Write(ovrMessageHandle message, ovrMessageType type, ovrRequest requestId, bool isError,
+                           int errorCode, uint64_t poppedNs) {
+    if (!g_Recorder.File) return;
+    uint64_t frameStartNs = __atomic_load_n(&g_Recorder.FrameStartNs, __ATOMIC_RELAXED);
+    ovrRecordedMessage recorded = {};
+    recorded.TimeNs = poppedNs - g_Recorder.StartNs;
+    recorded.RequestId = requestId;
+    recorded.Type = (uint32_t)type;
+    recorded.ErrorCode = errorCode;
+    recorded.Flags = isError ? RECORDING_FLAG_ERROR : 0;
+    recorded.Frame = __atomic_load_n(&g_Recorder.Frame, __ATOMIC_RELAXED);
+    recorded.FrameOffsetUs = poppedNs > frameStartNs ? (uint32_t)((poppedNs - frameStartNs) / 1000) : 0;
+    Recorder_WriteField(RECORDING_TAG_MESSAGE, &recorded, sizeof(recorded));
+    if (isError) {
+        Recorder_WriteText(RECORDING_TAG_ERROR_MESSAGE, ovr_Error_GetMessage(ovr_Message_GetError(message)));
+    }
+
+    // The payload values the handlers read
+    switch (type) {
+        case ovrMessage_Notification_GroupPresence_JoinIntentReceived: {
+            ovrGroupPresenceJoinIntentHandle intent = ovr_Message_GetGroupPresenceJoinIntent(message);
+            if (!intent) break;
+            Recorder_WriteText(RECORDING_TAG_DEEPLINK_MESSAGE, ovr_GroupPresenceJoinIntent_GetDeeplinkMessage(intent));
+            Recorder_WriteText(RECORDING_TAG_DESTINATION, ovr_GroupPresenceJoinIntent_GetDestinationApiName(intent));
+            Recorder_WriteText(RECORDING_TAG_LOBBY_SESSION, ovr_GroupPresenceJoinIntent_GetLobbySessionId(intent));
+            Recorder_WriteText(RECORDING_TAG_MATCH_SESSION, ovr_GroupPresenceJoinIntent_GetMatchSessionId(intent));
+            break;
+        }
+        case ovrMessage_Notification_GroupPresence_LeaveIntentReceived: {
+            ovrGroupPresenceLeaveIntentHandle intent = ovr_Message_GetGroupPresenceLeaveIntent(message);
+            if (!intent) break;
+            Recorder_WriteText(RECORDING_TAG_DESTINATION, ovr_GroupPresenceLeaveIntent_GetDestinationApiName(intent));
+            Recorder_WriteText(RECORDING_TAG_LOBBY_SESSION, ovr_GroupPresenceLeaveIntent_GetLobbySessionId(intent));
+            Recorder_WriteText(RECORDING_TAG_MATCH_SESSION, ovr_GroupPresenceLeaveIntent_GetMatchSessionId(intent));
+            break;
+        }
+        case ovrMessage_Notification_GroupPresence_InvitationsSent: {
+            ovrLaunchInvitePanelFlowResultHandle result = ovr_Message_GetLaunchInvitePanelFlowResult(message);
+            ovrUserArrayHandle users = result ? ovr_LaunchInvitePanelFlowResult_GetInvitedUsers(result) : NULL;
+            uint32_t count = users ? (uint32_t)ovr_UserArray_GetSize(users) : 0;
+            Recorder_WriteField(RECORDING_TAG_INVITED_USERS, &count, sizeof(count));
+            break;
+        }
+        case ovrMessage_GroupPresence_SendInvites: {
+            ovrSendInvitesResultHandle result = isError ? NULL : ovr_Message_GetSendInvitesResult(message);
+            ovrApplicationInviteArrayHandle invites = result ? ovr_SendInvitesResult_GetInvites(result) : NULL;
+            if (!invites) break;
+            uint32_t count = (uint32_t)ovr_ApplicationInviteArray_GetSize(invites);
+            Recorder_WriteField(RECORDING_TAG_INVITED_USERS, &count, sizeof(count));
+            break;
+        }
+        case ovrMessage_GroupPresence_LaunchInvitePanel: {
+            ovrInvitePanelResultInfoHandle result = isError ? NULL : ovr_Message_GetInvitePanelResultInfo(message);
+            if (!result) break;
+            uint8_t sent = ovr_InvitePanelResultInfo_GetInvitesSent(result) ? 1 : 0;
+            Recorder_WriteField(RECORDING_TAG_INVITES_SENT, &sent, sizeof(sent));
+            break;
+        }
+        default:
+            break;
+    }
+    g_Recorder.Messages++;
+}
+
+// ================================================================================
+// Platform Pump
+// ================================================================================
+// Messages are popped and decoded into app-owned ovrPlatformEvents: type,
+// request, error code, route and typed payload. With debug.xrpresence.
+// platform_thread set this happens on a background thread that hands events to
+// the frame thread through a lock-free single-producer ring; otherwise the frame
+// thread pops inline. Either way the frame thread applies at most
+// platform_budget events and roughly platform_budget_us of handler time per
+// frame, and leaves the rest for the next one, so a burst of notifications is
+// spread over a few frames instead of stalling one. When the ring is full the
+// pump stops popping and the SDK's own queue holds the backlog.
+#define PLATFORM_QUEUE_DEFAULT_EVENTS 256
+#define PLATFORM_QUEUE_MAX_EVENTS 65536
+#define PLATFORM_BUDGET_DEFAULT_EVENTS 32
+#define PLATFORM_BUDGET_DEFAULT_US 1000
+static const int PLATFORM_PUMP_POLL_US = 1000;  // The SDK has nothing to block on
+
+typedef struct {
+    ovrMessageHandle Message;   // Freed by the frame thread once handled
+    ovrMessageType Type;
+    int RouteIndex;             // -1 for types missing from ovr_message_types.h
+    ovrRequest RequestId;
+    bool IsError;
+    int ErrorCode;
+    uint64_t Payload;           // Typed payload of a routed type with a handler
+    uint64_t PoppedNs;
+} ovrPlatformEvent;
+
+typedef struct {
+    ovrPlatformEvent* Events;
+    uint64_t Mask;
+    uint64_t Head;              // Next event to apply; frame thread
+    uint64_t Tail;              // Next slot to fill; pump thread
+    bool Running;               // Pump thread started (frame thread only)
+    bool Quit;
+    pthread_t Thread;
+#ifdef __ANDROID__
+    ALooper* Looper;            // Frame thread's, woken when events arrive
+#endif
+    int BudgetEvents;
+    uint64_t BudgetNs;          // 0 = no time limit
+    bool HasPeeked;             // Inline mode: Peeked was popped but not applied
+    ovrPlatformEvent Peeked;
+
+    uint64_t FullPolls;         // Pump found the ring full; atomic
+    uint64_t MaxBacklog;
+    uint64_t LimitedFrames;     // Frames that left events for the next one
+    uint64_t LastHandoffNs;     // Popped to handled
+    uint64_t MaxHandoffNs;
+} ovrPlatformPump;
+
+static ovrPlatformPump g_PlatformPump;
+
+static void PlatformEvent_Decode(ovrMessageHandle message, ovrPlatformEvent* event) {
+    event->Message = message;
+    event->Type = ovr_Message_GetType(message);
+    event->RouteIndex = MessageTypeIndex(event->Type);
+    event->RequestId = ovr_Message_GetRequestID(message);
+    event->IsError = ovr_Message_IsError(message);
+    event->ErrorCode = event->IsError ? ovr_Error_GetCode(ovr_Message_GetError(message)) : 0;
+    event->Payload = 0;
+    if (event->RouteIndex >= 0 && g_MessageRoutes[event->RouteIndex].Handler) {
+        g_MessageRoutes[event->RouteIndex].Decode(message, &event->Payload);
+    }
+    event->PoppedNs = GetTimeNanos();
+    Recorder_Write(message, event->Type, event->RequestId, event->IsError, event->ErrorCode, event->PoppedNs);
+}
+
+static void* PlatformPumpThreadMain(void* arg) {
+    ovrPlatformPump* pump = (ovrPlatformPump*)arg;
+    prctl(PR_SET_NAME, (long)"XrPlatformPump", 0, 0, 0);
+
+    while (!__atomic_load_n(&pump->Quit, __ATOMIC_ACQUIRE)) {
+        int popped = 0;
+        for (;;) {
+            uint64_t tail = pump->Tail;
+            if (tail - __atomic_load_n(&pump->Head, __ATOMIC_ACQUIRE) > pump->Mask) {
+                __atomic_add_fetch(&pump->FullPolls, 1, __ATOMIC_RELAXED);
+                break;
+            }
+            ovrMessageHandle message = ovr_PopMessage();
+            if (!message) break;
+            PlatformEvent_Decode(message, &pump->Events[tail & pump->Mask]);
+            __atomic_store_n(&pump->Tail, tail + 1, __ATOMIC_RELEASE);
+            popped++;
+        }
+#ifdef __ANDROID__
+        if (popped > 0) {
+            ALooper_wake(pump->Looper);     // Cuts the idle-mode poll short
+        }
+#endif
+        usleep(PLATFORM_PUMP_POLL_US);
+    }
+    return NULL;
+}
+
+// Call after the handlers are registered and before the first request completes.
+static void PlatformPump_Start(ovrPlatformPump* pump, bool thread, uint32_t capacity, int budgetEvents,
+                               int budgetUs) {
+    pump->BudgetEvents = budgetEvents > 0 ? budgetEvents : INT32_MAX;
+    pump->BudgetNs = budgetUs > 0 ? (uint64_t)budgetUs * 1000 : 0;
+    if (!thread) return;
+
+    if (capacity == 0 || capacity > PLATFORM_QUEUE_MAX_EVENTS) {
+        LOGW(PLATFORM, "Platform queue size %u out of range, using %u events", capacity,
+             PLATFORM_QUEUE_DEFAULT_EVENTS);
+        capacity = PLATFORM_QUEUE_DEFAULT_EVENTS;
+    }
+    uint32_t size = 2;
+    while (size < capacity) size <<= 1;
+    pump->Events = (ovrPlatformEvent*)calloc(size, sizeof(ovrPlatformEvent));
+    pump->Mask = size - 1;
+    pump->Head = 0;
+    pump->Tail = 0;
+    pump->Quit = false;
+#ifdef __ANDROID__
+    pump->Looper = appState.NativeApp->looper;
+#endif
+    pthread_create(&pump->Thread, NULL, PlatformPumpThreadMain, pump);
+    pump->Running = true;
+    LOGI(PLATFORM, "Platform pump thread started (%u events, budget %d events / %d us)", size, budgetEvents,
+         budgetUs);
+}
+
+// Joins the pump thread and frees the events it handed over but nobody applied.
+static void PlatformPump_Stop(ovrPlatformPump* pump) {
+    if (pump->HasPeeked) {
+        ovr_FreeMessage(pump->Peeked.Message);
+        pump->HasPeeked = false;
+    }
+    if (!pump->Running) return;
+    __atomic_store_n(&pump->Quit, true, __ATOMIC_RELEASE);
+    pthread_join(pump->Thread, NULL);
+    pump->Running = false;
+    for (; pump->Head != pump->Tail; pump->Head++) {
+        ovr_FreeMessage(pump->Events[pump->Head & pump->Mask].Message);
+    }
+    free(pump->Events);
+    pump->Events = NULL;
+}
+
+// Next event for the frame thread: from the ring, or popped and decoded right
+// here without the pump thread. Returns false when there is none.
+static bool PlatformPump_Next(ovrPlatformPump* pump, ovrPlatformEvent* event) {
+    if (pump->HasPeeked) {
+        *event = pump->Peeked;
+        pump->HasPeeked = false;
+        return true;
+    }
+    if (!pump->Running) {
+        ovrMessageHandle message = ovr_PopMessage();
+        if (!message) return false;
+        PlatformEvent_Decode(message, event);
+        return true;
+    }
+    uint64_t head = pump->Head;
+    if (head == __atomic_load_n(&pump->Tail, __ATOMIC_ACQUIRE)) return false;
+    *event = pump->Events[head & pump->Mask];
+    __atomic_store_n(&pump->Head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Events handed over but not applied yet. Always 0 without the pump thread,
+// whose backlog stays in the SDK.
+static uint64_t PlatformPump_Backlog(const ovrPlatformPump* pump) {
+    if (!pump->Running) return pump->HasPeeked ? 1 : 0;
+    return __atomic_load_n(&pump->Tail, __ATOMIC_ACQUIRE) - pump->Head;
+}
+
+// Whether an event is waiting. Inline, this pops the next message ahead of
+// time, and PlatformPump_Next hands it out first.
+static bool PlatformPump_Pending(ovrPlatformPump* pump) {
+    if (pump->Running || pump->HasPeeked) return PlatformPump_Backlog(pump) > 0;
+    pump->HasPeeked = PlatformPump_Next(pump, &pump->Peeked);
+    return pump->HasPeeked;
+}
+
+static void HandlePlatformEvent(const ovrPlatformEvent* event) {
+    const char* name = MessageTypeName(event->Type);
+    Trace_Emit(TRACE_EVENT_PLATFORM_RESPONSE, (uint32_t)event->Type, event->ErrorCode, event->RequestId,
+               event->IsError ? TRACE_FLAG_ERROR : 0);
+    if (event->RequestId != 0) {
+        // Latency ends when the SDK delivered the response, not when its turn came
+        RequestTracker_Complete(event->RequestId, event->IsError, event->PoppedNs);
+        Spans_AsyncEnd(name, event->RequestId, event->ErrorCode);
+    } else {
+        Spans_Instant(name, "platform");    // Notification
+    }
+    LOGV(PLATFORM, "Platform message received: %s, isError=%d", name, event->IsError);
+
+    g_MessageKept = false;
+    if (event->RouteIndex < 0) {
+        g_UnknownMessages++;
+        LOGV(PLATFORM, "Unknown Platform message type: 0x%08X", (unsigned)event->Type);
+    } else {
+        ovrMessageRoute* route = &g_MessageRoutes[event->RouteIndex];
+        route->Received++;
+        route->Errors += event->IsError;
+        if (route->Handler) {
+            route->Thunk(route->Handler, event->Message, event->Payload);
+        } else {
+            LOGV(PLATFORM, "Unhandled Platform message: %s", name);
+        }
+    }
+    if (event->RequestId != 0) {
+        RequestAwaits_Complete(event->RequestId, event->Message);
+    }
+
+    if (!g_MessageKept) ovr_FreeMessage(event->Message);
+}
+
+// Applies this frame's share of Platform events. Returns the number handled.
+static int ProcessPlatformMessages() {
+    TraceScope trace("ProcessPlatformMessages", "platform");
+    ovrPlatformPump* pump = &g_PlatformPump;
+    uint64_t start = GetTimeNanos();
+    int count = 0;
+    ovrPlatformEvent event;
+    for (;;) {
+        if (count >= pump->BudgetEvents || (pump->BudgetNs != 0 && GetTimeNanos() - start >= pump->BudgetNs)) {
+            if (PlatformPump_Pending(pump)) pump->LimitedFrames++;
+            break;
+        }
+        if (!PlatformPump_Next(pump, &event)) break;
+        HandlePlatformEvent(&event);
+        count++;
+
+        uint64_t handoffNs = GetTimeNanos() - event.PoppedNs;
+        pump->LastHandoffNs = handoffNs;
+        if (handoffNs > pump->MaxHandoffNs) pump->MaxHandoffNs = handoffNs;
+    }
+    uint64_t backlog = PlatformPump_Backlog(pump);
+    if (backlog > pump->MaxBacklog) pump->MaxBacklog = backlog;
+
+    RequestTracker_CheckStuck(GetTimeNanos());
+    RequestAwaits_CheckTimeouts(GetTimeNanos());
+    InviteSender_Update(GetTimeNanos());
+    appState.PlatformMessagesHandled += count;
+    return count;
+}
+
+// Fills order[] with the indices of message types seen so far, busiest first.
+// Returns how many there are.
+static int GetBusiestMessageTypes(int* order) {
+    int count = 0;
+    for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+        if (g_MessageRoutes[i].Received == 0) continue;
+        int j = count++;
+        while (j > 0 && g_MessageRoutes[order[j - 1]].Received < g_MessageRoutes[i].Received) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    return count;
+}
+
+// ================================================================================
+// Presence Functions (Real Oculus Platform SDK)
+// ================================================================================
+static void GenerateLobbyId() {
+    snprintf(appState.LobbyId, sizeof(appState.LobbyId), "lobby_%d_%ld",
+             rand() % 10000, (long)time(NULL));
+    AppendLog("Generated lobby ID: %s", appState.LobbyId);
+}
+
+static void GenerateMatchSessionId() {
+    snprintf(appState.MatchSessionId, sizeof(appState.MatchSessionId), "match_%d_%ld",
+             rand() % 10000, (long)time(NULL));
+    AppendLog("Generated match session ID: %s", appState.MatchSessionId);
+}
+
+// Returns the presence generation to AwaitPresence on, 0 if nothing was accepted.
+static uint64_t SetGroupPresence() {
+    if (!appState.PlatformInitialized) {
+        AppendLogError("ERROR: Platform SDK not initialized yet!");
+        return 0;
+    }
+
+    AppendLog("Setting group presence with params:");
+
+    ovrPresenceState state = {};
+    if (appState.UseDestination) {
+        state.HasDestination = true;
+        AppendLog("  Destination: %s", DESTINATION_API_NAME);
+    } else {
+        AppendLog("  Destination: (not set)");
+    }
+
+    if (appState.UseLobbyId) {
+        if (strlen(appState.LobbyId) == 0) {
+            AppendLogWarn("  WARNING: LobbyId enabled but empty!");
+        }
+        state.HasLobbyId = true;
+        snprintf(state.LobbyId, sizeof(state.LobbyId), "%s", appState.LobbyId);
+        AppendLog("  LobbyId: %s", appState.LobbyId);
+    } else {
+        AppendLog("  LobbyId: (not set)");
+    }
+
+    if (appState.UseMatchSessionId) {
+        if (strlen(appState.MatchSessionId) == 0) {
+            AppendLogWarn("  WARNING: MatchSessionId enabled but empty!");
+        }
+        state.HasMatchSessionId = true;
+        snprintf(state.MatchSessionId, sizeof(state.MatchSessionId), "%s", appState.MatchSessionId);
+        AppendLog("  MatchSessionId: %s", appState.MatchSessionId);
+    } else {
+        AppendLog("  MatchSessionId: (not set)");
+    }
+
+    if (appState.UseIsJoinable) {
+        state.IsJoinable = true;
+        AppendLog("  IsJoinable: true");
+        RequestTracker_JoinFlowStart(GetTimeNanos());
+    } else {
+        AppendLog("  IsJoinable: (not set)");
+    }
+
+    // Sent now, or folded into the follow-up of the request in flight
+    uint64_t generation = Presence_Update(&state);
+    if (g_Presence.InFlightId != 0) {
+        snprintf(appState.StatusText, sizeof(appState.StatusText), "Setting presence...");
+    }
+    return generation;
+}
+
+static void ClearGroupPresence() {
+    AppendLog("Clearing group presence...");
+    RequestAwaits_CancelAll();     // Reset stops any running flow
+
+    if (appState.PlatformInitialized) {
+        ovrRequest req = ovr_GroupPresence_Clear();
+        TrackPlatformRequest(ovrMessage_GroupPresence_Clear, req);
+        LOGI(PLATFORM, "ovr_GroupPresence_Clear request: %llu", (unsigned long long)req);
+    }
+
+    appState.PresenceSet = false;
+    appState.IsJoinable = false;
+    Presence_Reset();
+    g_Requests.JoinFlowStartNs = 0;
+    appState.LobbyId[0] = '\0';
+    appState.MatchSessionId[0] = '\0';
+    snprintf(appState.StatusText, sizeof(appState.StatusText), "Presence cleared");
+}
+
+// Returns the request, 0 if none was issued.
+static ovrRequest LaunchInvitePanel() {
+    if (!appState.PlatformInitialized) {
+        AppendLogError("ERROR: Platform SDK not initialized yet!");
+        return 0;
+    }
+
+    if (!appState.PresenceSet || !appState.IsJoinable) {
+        AppendLogWarn("!! WARNING: Launching invite panel but:");
+        if (!appState.PresenceSet) AppendLog("   - Presence NOT set!");
+        if (!appState.IsJoinable) AppendLog("   - User NOT joinable!");
+        AppendLog("   This will cause panel to close immediately!");
+    }
+
+    AppendLog("Launching invite panel...");
+
+    // Create invite options (can be NULL for defaults, but let's be explicit)
+    ovrInviteOptionsHandle options = ovr_InviteOptions_Create();
+
+    // Launch the system invite panel (async)
+    ovrRequest req = ovr_GroupPresence_LaunchInvitePanel(options);
+    TrackPlatformRequest(ovrMessage_GroupPresence_LaunchInvitePanel, req);
+    LOGI(PLATFORM, "ovr_GroupPresence_LaunchInvitePanel request: %llu", (unsigned long long)req);
+
+    ovr_InviteOptions_Destroy(options);
+
+    snprintf(appState.StatusText, sizeof(appState.StatusText), "Opening invite panel...");
+    return req;
+}
+
+static void TestBuggyFlow() {
+    AppendLog("=== BUGGY FLOW (Developer's Issue) ===");
+    AppendLog("Order: Panel -> Presence (WRONG!)");
+    AppendLog("Result: Panel closes immediately");
+
+    LaunchInvitePanel();  // Called too early!
+    SetGroupPresence();   // Too late
+}
+
+// Sequenced flow: the invite panel opens in the frame the presence ack arrives.
+static ovrFlow TestCorrectFlow() {
+    AppendLog("=== CORRECT FLOW ===");
+    AppendLog("Order: Lobby -> Presence -> Panel");
+
+    GenerateLobbyId();
+    ovrRequestResult presence = co_await AwaitPresence(SetGroupPresence());
+    if (!presence.Ok()) {
+        AppendLogError("Presence not confirmed (%s%s%s), not opening invite panel",
+                       REQUEST_STATUS_NAMES[presence.Status], presence.ErrorMessage[0] ? ": " : "",
+                       presence.ErrorMessage);
+        co_return;
+    }
+
+    AppendLog("Presence confirmed, opening invite panel");
+    ovrRequestResult panel = co_await AwaitRequest(LaunchInvitePanel(), 0);  // Open while the user picks
+    if (panel.Status == REQUEST_STATUS_CANCELLED) co_return;
+    AppendLog("Correct flow finished: invite panel %s", REQUEST_STATUS_NAMES[panel.Status]);
+}
+
+// Set, Clear, then the same Set again before the first ack arrives. The first
+// ack predates the clear, so the panel may only open once the re-sent state
+// is acknowledged; the stub closes it at once if the server is still cleared.
+static ovrFlow TestSetClearSetFlow() {
+    AppendLog("=== SET / CLEAR / SET FLOW ===");
+
+    GenerateLobbyId();
+    char lobbyId[sizeof(appState.LobbyId)];
+    snprintf(lobbyId, sizeof(lobbyId), "%s", appState.LobbyId);
+    SetGroupPresence();
+    ClearGroupPresence();
+    snprintf(appState.LobbyId, sizeof(appState.LobbyId), "%s", lobbyId);
+    ovrRequestResult presence = co_await AwaitPresence(SetGroupPresence());
+    if (!presence.Ok()) {
+        AppendLogError("Presence not confirmed (%s), not opening invite panel",
+                       REQUEST_STATUS_NAMES[presence.Status]);
+        co_return;
+    }
+
+    AppendLog("Presence confirmed after clear, opening invite panel");
+    ovrRequestResult panel = co_await AwaitRequest(LaunchInvitePanel(), 0);
+    if (panel.Status == REQUEST_STATUS_CANCELLED) co_return;
+    AppendLog("Set/clear/set flow finished: invite panel %s", REQUEST_STATUS_NAMES[panel.Status]);
+}
+
+// Invite button: if a presence update is still in flight, wait for its ack
+// instead of opening a panel that would close immediately.
+static ovrFlow OpenInvitePanelFlow() {
+    if (g_Presence.InFlightId != 0) {
+        AppendLog("Waiting for presence ack before opening the invite panel...");
+        ovrRequestResult presence = co_await AwaitPresence(g_Presence.Generation);
+        if (!presence.Ok()) {
+            AppendLogError("Presence not confirmed (%s), not opening invite panel",
+                           REQUEST_STATUS_NAMES[presence.Status]);
+            co_return;
+        }
+    }
+    LaunchInvitePanel();
+}
+
+// ================================================================================
+// ImGui Rendering
+// ================================================================================
+static bool g_ImGuiInitialized = false;
+
+static void InitImGui() {
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2((float)g_Atlas.CanvasWidth, (float)g_Atlas.CanvasHeight);
+    io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+    io.FontGlobalScale = 2.5f;
+
+    ImGui::StyleColorsDark();
+    ImGuiStyle& style = ImGui::GetStyle();
+    style.WindowRounding = 12.0f;
+    style.FrameRounding = 8.0f;
+    style.ItemSpacing = ImVec2(16, 12);
+    style.FramePadding = ImVec2(12, 8);
+    style.Colors[ImGuiCol_WindowBg] = ImVec4(0.08f, 0.08f, 0.12f, 0.95f);
+    style.Colors[ImGuiCol_Button] = ImVec4(0.2f, 0.4f, 0.8f, 1.0f);
+    style.Colors[ImGuiCol_ButtonHovered] = ImVec4(0.3f, 0.5f, 0.9f, 1.0f);
+    style.Colors[ImGuiCol_ButtonActive] = ImVec4(0.15f, 0.3f, 0.6f, 1.0f);
+
+    ImGui_ImplOpenGL3_Init("#version 300 es");
+    g_ImGuiInitialized = true;
+
+    LOGI(RENDER, "ImGui initialized");
+}
+
+static void ShutdownImGui() {
+    if (g_ImGuiInitialized) {
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui::DestroyContext();
+        g_ImGuiInitialized = false;
+    }
+}
+
+static void DrawStatusPanel() {
+    // Title
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.3f, 0.8f, 1.0f, 1.0f));
     ImGui::Text("Group Presence / Invite Panel Test");
     ImGui::PopStyleColor();
@@ -568,11 +3438,9 @@ static void RenderImGuiToTexture(GLuint targetTexture) {
     if (strlen(appState.MatchSessionId) > 0) {
         ImGui::Text("Match: %s", appState.MatchSessionId);
     }
+}
 
-    ImGui::Spacing();
-    ImGui::Separator();
-    ImGui::Spacing();
-
+static void DrawControlsPanel() {
     // Parameter toggles - let users experiment
     ImGui::Text("Parameters to include in SetPresence:");
     ImGui::Checkbox("Destination", &appState.UseDestination);
@@ -601,56 +3469,599 @@ static void RenderImGuiToTexture(GLuint targetTexture) {
     if (ImGui::Button("2. Set Presence", ImVec2(buttonWidth, buttonHeight))) {
         SetGroupPresence();
     }
-    ImGui::SameLine();
-    if (ImGui::Button("3. Open Invite Panel", ImVec2(buttonWidth, buttonHeight))) {
-        LaunchInvitePanel();
+    ImGui::SameLine();
+    if (ImGui::Button("3. Open Invite Panel", ImVec2(buttonWidth, buttonHeight))) {
+        OpenInvitePanelFlow();
+    }
+
+    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.4f, 0.4f, 0.5f, 1.0f));
+    if (ImGui::Button("Clear / Reset", ImVec2(buttonWidth, buttonHeight))) {
+        ClearGroupPresence();
+    }
+    ImGui::PopStyleColor();
+}
+
+// Log panel view state. Filtering keeps an index of matching line numbers that
+// is extended incrementally as lines arrive and trimmed as they are evicted, so
+// neither drawing nor filtering ever walks the whole log.
+static const char* const LOG_QUICK_SEARCHES[] = {"FAILED", "Presence", "Invite", "Session"};
+
+typedef struct {
+    char Search[64];
+    bool MatchesOnly;               // Hide lines that do not contain Search
+    ovrLogLevel MinLevel;
+    ImVector<uint64_t> Index;       // Monotonic line numbers passing the filter
+    int IndexStart;                 // Entries before this have been evicted
+    uint64_t IndexedEnd;            // Lines below this have been considered
+    bool IndexValid;
+} ovrLogView;
+
+static ovrLogView g_LogView;
+
+// Case-insensitive search within [text, text + length). Returns NULL if absent.
+static const char* FindNoCase(const char* text, uint32_t length, const char* needle) {
+    size_t needleLength = strlen(needle);
+    if (needleLength == 0 || needleLength > length) return NULL;
+    for (uint32_t i = 0; i + needleLength <= length; i++) {
+        size_t k = 0;
+        while (k < needleLength && tolower((unsigned char)text[i + k]) == tolower((unsigned char)needle[k])) {
+            k++;
+        }
+        if (k == needleLength) return text + i;
+    }
+    return NULL;
+}
+
+static bool LogView_IsFiltered(const ovrLogView* view) {
+    return view->MinLevel != LOG_LEVEL_INFO || (view->MatchesOnly && view->Search[0]);
+}
+
+static void LogView_UpdateIndex(ovrLogView* view, const ovrLogRing* log) {
+    if (!view->IndexValid) {
+        view->Index.resize(0);
+        view->IndexStart = 0;
+        view->IndexedEnd = log->FirstLine;
+        view->IndexValid = true;
+    }
+    if (view->IndexedEnd < log->FirstLine) {
+        view->IndexedEnd = log->FirstLine;  // Evicted before they were seen
+    }
+
+    for (uint64_t n = view->IndexedEnd; n < log->EndLine; n++) {
+        const char* text;
+        const ovrLogLine* line = LogRing_Get(log, (uint32_t)(n - log->FirstLine), &text);
+        if (line->Level < view->MinLevel) continue;
+        if (view->MatchesOnly && view->Search[0] && !FindNoCase(text, line->Length, view->Search)) continue;
+        view->Index.push_back(n);
+    }
+    view->IndexedEnd = log->EndLine;
+
+    while (view->IndexStart < view->Index.Size && view->Index[view->IndexStart] < log->FirstLine) {
+        view->IndexStart++;
+    }
+    // Compact once the dead prefix dominates, keeping trimming amortized O(1)
+    if (view->IndexStart > 1024 && view->IndexStart * 2 > view->Index.Size) {
+        view->Index.erase(view->Index.begin(), view->Index.begin() + view->IndexStart);
+        view->IndexStart = 0;
+    }
+}
+
+static void DrawLogLine(const ovrLogRing* log, uint32_t i, const char* search) {
+    const char* text;
+    const ovrLogLine* line = LogRing_Get(log, i, &text);
+    ImGui::TextDisabled("%8.3f", (line->TimeNs - log->StartTimeNs) / 1e9);
+    ImGui::SameLine();
+
+    // Highlight behind every match, measured on the line's own text
+    if (search[0]) {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float height = ImGui::GetTextLineHeight();
+        size_t searchLength = strlen(search);
+        const char* end = text + line->Length;
+        const char* match = text;
+        while ((match = FindNoCase(match, (uint32_t)(end - match), search)) != NULL) {
+            float x0 = ImGui::CalcTextSize(text, match).x;
+            float x1 = x0 + ImGui::CalcTextSize(match, match + searchLength).x;
+            drawList->AddRectFilled(ImVec2(origin.x + x0, origin.y), ImVec2(origin.x + x1, origin.y + height),
+                                    IM_COL32(90, 90, 200, 200));
+            match += searchLength;
+        }
+    }
+
+    if (line->Level != LOG_LEVEL_INFO) {
+        ImGui::PushStyleColor(ImGuiCol_Text, line->Level == LOG_LEVEL_ERROR ?
+            IM_COL32(255, 100, 100, 255) : IM_COL32(255, 220, 100, 255));
+    }
+    ImGui::TextUnformatted(text, text + line->Length);
+    if (line->Level != LOG_LEVEL_INFO) {
+        ImGui::PopStyleColor();
+    }
+}
+
+static void DrawLogPanel() {
+    ovrLogView* view = &g_LogView;
+
+    // Search and quick filters. There is rarely a keyboard, so common searches
+    // are one click away.
+    ImGui::SetNextItemWidth(300);
+    bool filterChanged = ImGui::InputTextWithHint("##LogSearch", "Search", view->Search, sizeof(view->Search)) &&
+                         view->MatchesOnly;
+    for (size_t i = 0; i < sizeof(LOG_QUICK_SEARCHES) / sizeof(LOG_QUICK_SEARCHES[0]); i++) {
+        ImGui::SameLine();
+        if (ImGui::Button(LOG_QUICK_SEARCHES[i])) {
+            bool same = strcmp(view->Search, LOG_QUICK_SEARCHES[i]) == 0;
+            snprintf(view->Search, sizeof(view->Search), "%s", same ? "" : LOG_QUICK_SEARCHES[i]);
+            filterChanged = filterChanged || view->MatchesOnly;
+        }
+    }
+    filterChanged |= ImGui::Checkbox("Matches only", &view->MatchesOnly);
+    ImGui::SameLine();
+    int minLevel = (int)view->MinLevel;
+    filterChanged |= ImGui::RadioButton("All", &minLevel, LOG_LEVEL_INFO);
+    ImGui::SameLine();
+    filterChanged |= ImGui::RadioButton("Warnings", &minLevel, LOG_LEVEL_WARN);
+    ImGui::SameLine();
+    filterChanged |= ImGui::RadioButton("Errors", &minLevel, LOG_LEVEL_ERROR);
+    view->MinLevel = (ovrLogLevel)minLevel;
+    if (filterChanged) {
+        view->IndexValid = false;
+    }
+
+    // Log fills the panel above the button row. Only the visible rows are
+    // submitted, so the cost follows the panel height, not the log length.
+    const float buttonHeight = 60.0f;
+    ImGui::BeginChild("LogRegion", ImVec2(0, -(buttonHeight + ImGui::GetStyle().ItemSpacing.y)), true,
+                      ImGuiWindowFlags_HorizontalScrollbar);
+    bool filtered = LogView_IsFiltered(view);
+    int rows = (int)LogRing_Count(&g_Log);
+    if (filtered) {
+        LogView_UpdateIndex(view, &g_Log);
+        rows = view->Index.Size - view->IndexStart;
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin(rows);
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            uint32_t i = filtered ? (uint32_t)(view->Index[view->IndexStart + row] - g_Log.FirstLine) : (uint32_t)row;
+            DrawLogLine(&g_Log, i, view->Search);
+        }
+    }
+    clipper.End();
+
+    if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY() - 10)
+        ImGui::SetScrollHereY(1.0f);
+    ImGui::EndChild();
+
+    if (ImGui::Button("Clear Log", ImVec2(200, buttonHeight))) {
+        LogRing_Clear(&g_Log);
+    }
+    ImGui::SameLine();
+    ImGui::Text("%u lines, %llu evicted", LogRing_Count(&g_Log), (unsigned long long)g_Log.Evicted);
+}
+
+static void DrawMessageCountsSection() {
+    if (!ImGui::CollapsingHeader("Platform Messages")) {
+        return;
+    }
+    int order[MESSAGE_TYPE_COUNT];
+    int count = GetBusiestMessageTypes(order);
+    if (ImGui::BeginTable("MessageCounts", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Received");
+        ImGui::TableSetupColumn("Errors");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < count; i++) {
+            const ovrMessageRoute* route = &g_MessageRoutes[order[i]];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(MESSAGE_TYPE_NAMES[order[i]]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)route->Received);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)route->Errors);
+        }
+        ImGui::EndTable();
+    }
+    if (g_UnknownMessages > 0) {
+        ImGui::Text("Unknown types: %llu", (unsigned long long)g_UnknownMessages);
+    }
+}
+
+static void DrawDiagnosticsPanel() {
+    ImGui::Text("Panel frames skipped: %llu",
+                (unsigned long long)__atomic_load_n(&appState.PanelSkippedShown, __ATOMIC_RELAXED));
+    XrExtent2Di atlasExtent = GetAtlasExtent(GetPanelScale());
+    ImGui::Text("Panel resolution: %.0f%% (%dx%d)%s", GetPanelScale() * 100.0f,
+                atlasExtent.width, atlasExtent.height,
+                appState.AdaptiveResolution ? "" : " fixed");
+
+    // Show cursor position for debugging
+    if (appState.HoverPanel >= 0) {
+        ImGui::Text("Cursor: %.0f, %.0f (%s)", floorf(appState.CursorX + 0.5f),
+                    floorf(appState.CursorY + 0.5f), g_Panels[appState.HoverPanel].Title);
+    } else {
+        ImGui::Text("Cursor: off panel");
+    }
+
+    ImGui::Text("Log sink: %llu written, %llu dropped",
+                (unsigned long long)__atomic_load_n(&appState.LogWrittenShown, __ATOMIC_RELAXED),
+                (unsigned long long)__atomic_load_n(&appState.LogDroppedShown, __ATOMIC_RELAXED));
+    ImGui::Text("Log suppressed:");
+    for (int cat = 0; cat < LOG_CAT_COUNT; cat++) {
+        ImGui::SameLine();
+        ImGui::Text("%s %llu", LOG_CATEGORY_NAMES[cat],
+                    (unsigned long long)__atomic_load_n(&appState.LogSuppressedShown[cat], __ATOMIC_RELAXED));
+    }
+
+    ImGui::Text("Platform pump: %s, backlog %llu (max %llu), budget-limited frames %llu",
+                g_PlatformPump.Running ? "thread" : "inline",
+                (unsigned long long)PlatformPump_Backlog(&g_PlatformPump),
+                (unsigned long long)g_PlatformPump.MaxBacklog, (unsigned long long)g_PlatformPump.LimitedFrames);
+    ImGui::Text("Platform handoff: %.2f ms (max %.2f), ring full %llu",
+                g_PlatformPump.LastHandoffNs / 1e6, g_PlatformPump.MaxHandoffNs / 1e6,
+                (unsigned long long)__atomic_load_n(&g_PlatformPump.FullPolls, __ATOMIC_RELAXED));
+    ImGui::Text("Presence updates: %llu, sent %llu, superseded %llu, unchanged %llu%s",
+                (unsigned long long)g_Presence.Updates, (unsigned long long)g_Presence.Sent,
+                (unsigned long long)g_Presence.Superseded, (unsigned long long)g_Presence.Unchanged,
+                g_Presence.FollowUp ? " (follow-up queued)" : "");
+    ImGui::Text("Invitable users: %u cached of %u, %u pages, first page %.1f ms, slowest %.1f ms",
+                g_Invitable.Count, g_Invitable.Capacity, g_Invitable.Pages, g_Invitable.FirstPageNs / 1e6,
+                g_Invitable.MaxPageNs / 1e6);
+    ImGui::Text("Invitable duplicates %u, dropped %u", g_Invitable.Duplicates, g_Invitable.Dropped);
+    ImGui::Text("Invite sender: %d/%d in flight, %.1f/%.1f batches/s, %llu retries, slowest batch %.1f ms",
+                g_InviteSender.InFlight, g_InviteSender.MaxInFlight, g_InviteSender.CurrentRate, g_InviteSender.Rate,
+                (unsigned long long)g_InviteSender.Retries, g_InviteSender.MaxBatchNs / 1e6);
+
+    ImGui::Spacing();
+    DrawProfilerSection();
+    DrawMessageCountsSection();
+    DrawRequestSection();
+}
+
+// Rows come from the invitable users cache and only the visible ones are
+// submitted. How far down the list they reach drives page prefetching.
+static void DrawFriendsPanel() {
+    ovrInvitableCache* cache = &g_Invitable;
+    if (cache->Pages == 0 && cache->PageRequest != 0) {
+        ImGui::Text("Loading invitable users...");
+    } else {
+        ImGui::Text("%u users%s, %u selected", cache->Count, cache->HasNextPage ? "+" : "", cache->SelectedCount);
+    }
+    if (cache->Failed) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "(load failed)");
+    }
+    const ovrInviteSender* sender = &g_InviteSender;
+    if (sender->Ids.Size > 0) {
+        ImGui::Text("Invites: %u/%d sent, %u failed, %d in flight, %.1f users/s", sender->UsersSent,
+                    sender->Ids.Size, sender->UsersFailed, sender->InFlight, InviteSender_Throughput());
+    } else {
+        ImGui::TextDisabled("Select users, then Send Invites");
+    }
+
+    const float buttonHeight = 60.0f;
+    ImGui::BeginChild("FriendsRegion", ImVec2(0, -(buttonHeight + ImGui::GetStyle().ItemSpacing.y)), true);
+    uint32_t visibleEnd = 0;
+    ImGuiListClipper clipper;
+    clipper.Begin((int)cache->Count);
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            ovrInvitableUser* user = &cache->Users[row];
+            ImGui::PushID(row);
+            if (ImGui::Selectable(user->DisplayName, user->Selected)) {
+                Invitable_ToggleSelected(user);
+            }
+            ImGui::SameLine(560);
+            ImGui::TextDisabled("%s", user->OculusId);
+            ImGui::PopID();
+        }
+        if ((uint32_t)clipper.DisplayEnd > visibleEnd) visibleEnd = (uint32_t)clipper.DisplayEnd;
+    }
+    clipper.End();
+    if (cache->Pages > 0 && cache->PageRequest != 0) {
+        ImGui::TextDisabled("Loading more...");
+    }
+    ImGui::EndChild();
+    cache->VisibleEnd = visibleEnd;
+    Invitable_Prefetch();
+
+    if (ImGui::Button("Refresh", ImVec2(200, buttonHeight))) {
+        Invitable_Load();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear Selection", ImVec2(280, buttonHeight))) {
+        for (uint32_t i = 0; i < cache->Count; i++) {
+            if (cache->Users[i].Selected) Invitable_ToggleSelected(&cache->Users[i]);
+        }
+    }
+    ImGui::SameLine();
+    ImGui::BeginDisabled(cache->SelectedCount == 0);
+    if (ImGui::Button("Send Invites", ImVec2(280, buttonHeight))) {
+        ImVector<ovrID> ids;
+        ids.reserve((int)cache->SelectedCount);
+        for (uint32_t i = 0; i < cache->Count; i++) {
+            if (!cache->Users[i].Selected) continue;
+            ids.push_back(cache->Users[i].Id);
+            Invitable_ToggleSelected(&cache->Users[i]);
+        }
+        InviteSender_Queue(ids.Data, (uint32_t)ids.Size);
+    }
+    ImGui::EndDisabled();
+}
+
+// Static panel: only draw what changes a few times per session at most, and no
+// child windows, since exactly one draw list is captured per static panel.
+static void DrawInstructionsPanel() {
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.3f, 0.8f, 1.0f, 1.0f));
+    ImGui::Text("How to test%s", appState.PlatformInitialized ? "" : " (waiting for Platform SDK)");
+    ImGui::PopStyleColor();
+    ImGui::Text("Point the controller at a button, pull the trigger to click.");
+    ImGui::Text("1. Generate a lobby (and optionally a match)");
+    ImGui::Text("2. Set presence - it must be joinable");
+    ImGui::Text("3. Open the invite panel");
+    ImGui::Spacing();
+    ImGui::Text("App ID: %s", APP_ID);
+    ImGui::Text("Destination: %s", DESTINATION_API_NAME);
+}
+
+static void (*const PANEL_DRAW_FUNCS[PANEL_COUNT])() = {
+    DrawStatusPanel,
+    DrawControlsPanel,
+    DrawLogPanel,
+    DrawDiagnosticsPanel,
+    DrawFriendsPanel,
+    DrawInstructionsPanel,
+};
+
+// Per static panel draw data, split out of the frame's draw data by
+// BuildImGuiFrame. Valid until the next ImGui frame, like the frame's own.
+static ImDrawData g_StaticDrawData[PANEL_COUNT];
+
+// Moves a static panel's window draw list out of the frame's draw data into its
+// own, framed so the panel renders at the origin of a panel-sized image.
+static void SplitStaticPanel(ImDrawData* frame, ImDrawList* list, const ovrPanel* panel, ImDrawData* out) {
+    out->Clear();
+    if (!frame->CmdLists.find_erase(list)) return;  // Nothing drawn
+    frame->CmdListsCount--;
+    frame->TotalVtxCount -= list->VtxBuffer.Size;
+    frame->TotalIdxCount -= list->IdxBuffer.Size;
+
+    out->AddDrawList(list);
+    out->Valid = true;
+    out->DisplayPos = ImVec2((float)panel->AtlasX, (float)panel->AtlasY);
+    out->DisplaySize = ImVec2((float)panel->Width, (float)panel->Height);
+    out->FramebufferScale = ImVec2(1.0f, 1.0f);
+}
+
+// Builds the UI for this frame and returns its draw data. This runs every frame
+// so button clicks are processed even when the panel image is not re-rendered.
+static ImDrawData* BuildImGuiFrame() {
+    if (!g_ImGuiInitialized) return NULL;
+
+    // Update ImGui input. The cursor is snapped to whole pixels so sub-pixel
+    // controller jitter does not dirty an otherwise unchanged panel.
+    ImGuiIO& io = ImGui::GetIO();
+    if (appState.HoverPanel >= 0) {
+        io.MousePos = ImVec2(floorf(appState.CursorX + 0.5f), floorf(appState.CursorY + 0.5f));
+    } else {
+        io.MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+    }
+    io.MouseDown[0] = appState.TriggerPressed;
+
+    // Render at the current adaptive scale; layout stays in logical units
+    io.DisplayFramebufferScale = ImVec2(GetPanelScale(), GetPanelScale());
+
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+
+    // One window per panel, pinned to its canvas region. The window clip rects
+    // keep every panel inside its own region of the shared image.
+    ImDrawList* staticLists[PANEL_COUNT] = {};
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        const ovrPanel* panel = &g_Panels[i];
+        ImGuiWindowFlags flags =
+            ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse;
+        if (panel->Static) flags |= ImGuiWindowFlags_NoInputs;
+        ImGui::SetNextWindowPos(ImVec2((float)panel->AtlasX, (float)panel->AtlasY), ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImVec2((float)panel->Width, (float)panel->Height), ImGuiCond_Always);
+        ImGui::Begin(panel->Title, NULL, flags);
+        PANEL_DRAW_FUNCS[i]();
+        if (panel->Static) staticLists[i] = ImGui::GetWindowDrawList();
+        ImGui::End();
+    }
+
+    // Draw cursor crosshair so user can see where they're pointing
+    if (appState.HoverPanel >= 0) {
+        const ovrPanel* panel = &g_Panels[appState.HoverPanel];
+        ImDrawList* drawList = ImGui::GetForegroundDrawList();
+        float cx = io.MousePos.x;
+        float cy = io.MousePos.y;
+        ImU32 cursorColor = appState.TriggerPressed ?
+            IM_COL32(255, 100, 100, 255) : IM_COL32(100, 255, 100, 255);
+
+        // Draw crosshair, clipped to the hovered panel so it never bleeds into a neighbour
+        drawList->PushClipRect(ImVec2((float)panel->AtlasX, (float)panel->AtlasY),
+                               ImVec2((float)(panel->AtlasX + panel->Width),
+                                      (float)(panel->AtlasY + panel->Height)), true);
+        drawList->AddLine(ImVec2(cx - 20, cy), ImVec2(cx + 20, cy), cursorColor, 3.0f);
+        drawList->AddLine(ImVec2(cx, cy - 20), ImVec2(cx, cy + 20), cursorColor, 3.0f);
+        drawList->AddCircle(ImVec2(cx, cy), 15.0f, cursorColor, 16, 3.0f);
+        drawList->PopClipRect();
+    }
+
+    ImGui::Render();
+
+    // What remains is exactly the atlas
+    ImDrawData* drawData = ImGui::GetDrawData();
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        if (staticLists[i]) {
+            SplitStaticPanel(drawData, staticLists[i], &g_Panels[i], &g_StaticDrawData[i]);
+        }
+    }
+    drawData->DisplaySize = ImVec2((float)g_Atlas.Width, (float)g_Atlas.Height);
+    return drawData;
+}
+
+static void RenderImGuiToTexture(GLuint framebuffer, int width, int height, ImDrawData* drawData) {
+    TraceScope trace("RenderImGuiToTexture", "render");
+    // The framebuffer already has the swapchain image attached
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    // The whole image is redrawn, so tell the driver the old contents need not
+    // be loaded into tile memory. The color result itself must survive for the
+    // compositor, and there is no depth/stencil attachment to discard afterwards.
+    const GLenum colorAttachment = GL_COLOR_ATTACHMENT0;
+    glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, &colorAttachment);
+
+    // Clear the whole image; the panels only cover their scaled regions
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    ImGui_ImplOpenGL3_RenderDrawData(drawData);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// ================================================================================
+// Panel Change Detection
+// ================================================================================
+// 64-bit FNV-1a style mix, consumed a word at a time so hashing the vertex stream
+// stays far cheaper than rendering it.
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    while (size >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+        bytes += sizeof(word);
+        size -= sizeof(word);
+    }
+    while (size > 0) {
+        hash = (hash ^ *bytes++) * 0x100000001B3ull;
+        size--;
     }
+    return hash;
+}
 
-    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.4f, 0.4f, 0.5f, 1.0f));
-    if (ImGui::Button("Clear / Reset", ImVec2(buttonWidth, buttonHeight))) {
-        ClearGroupPresence();
+static uint64_t HashString(uint64_t hash, const char* str) {
+    return HashBytes(hash, str, strlen(str) + 1);
+}
+
+// Hash of everything the UI reads from appState plus the cursor.
+static uint64_t HashPanelInputs() {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    const ImVec2 mousePos = ImGui::GetIO().MousePos;
+    hash = HashBytes(hash, &mousePos, sizeof(mousePos));
+    const bool flags[] = {
+        appState.TriggerPressed, appState.PlatformInitialized,
+        appState.PresenceSet, appState.IsJoinable,
+        appState.UseDestination, appState.UseLobbyId,
+        appState.UseMatchSessionId, appState.UseIsJoinable,
+    };
+    hash = HashBytes(hash, flags, sizeof(flags));
+    hash = HashBytes(hash, &appState.PanelScaleLevel, sizeof(appState.PanelScaleLevel));
+    const uint64_t skippedShown = __atomic_load_n(&appState.PanelSkippedShown, __ATOMIC_RELAXED);
+    hash = HashBytes(hash, &skippedShown, sizeof(skippedShown));
+    hash = HashString(hash, appState.LobbyId);
+    hash = HashString(hash, appState.MatchSessionId);
+    hash = HashString(hash, appState.StatusText);
+    hash = HashBytes(hash, &g_Log.Version, sizeof(g_Log.Version));
+    hash = HashBytes(hash, &g_Invitable.Version, sizeof(g_Invitable.Version));
+    return hash;
+}
+
+// Hash of the vertex/index/command stream ImGui produced for this frame.
+static uint64_t HashDrawData(uint64_t hash, const ImDrawData* drawData) {
+    hash = HashBytes(hash, &drawData->CmdListsCount, sizeof(drawData->CmdListsCount));
+    for (int n = 0; n < drawData->CmdListsCount; n++) {
+        const ImDrawList* cmdList = drawData->CmdLists[n];
+        hash = HashBytes(hash, cmdList->VtxBuffer.Data, cmdList->VtxBuffer.size_in_bytes());
+        hash = HashBytes(hash, cmdList->IdxBuffer.Data, cmdList->IdxBuffer.size_in_bytes());
+        for (int i = 0; i < cmdList->CmdBuffer.Size; i++) {
+            const ImDrawCmd* cmd = &cmdList->CmdBuffer[i];
+            hash = HashBytes(hash, &cmd->ClipRect, sizeof(cmd->ClipRect));
+            hash = HashBytes(hash, &cmd->TextureId, sizeof(cmd->TextureId));
+            hash = HashBytes(hash, &cmd->VtxOffset, sizeof(cmd->VtxOffset));
+            hash = HashBytes(hash, &cmd->IdxOffset, sizeof(cmd->IdxOffset));
+            hash = HashBytes(hash, &cmd->ElemCount, sizeof(cmd->ElemCount));
+        }
     }
-    ImGui::PopStyleColor();
+    return hash;
+}
 
-    ImGui::Spacing();
-    ImGui::Separator();
-    ImGui::Spacing();
+static uint64_t HashPanelFrame(const ImDrawData* drawData) {
+    return HashDrawData(HashPanelInputs(), drawData);
+}
 
-    // Log window
-    ImGui::Text("Log:");
-    ImGui::BeginChild("LogRegion", ImVec2(0, 180), true);
-    ImGui::TextUnformatted(appState.LogBuffer);
-    if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY() - 10)
-        ImGui::SetScrollHereY(1.0f);
-    ImGui::EndChild();
+// ================================================================================
+// Static Panels
+// ================================================================================
+// Panels that change a handful of times per session get a single-image swapchain
+// created with XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT. They are rendered once and
+// their layer is re-submitted every frame at no further cost; a content change
+// re-creates the swapchain, since a static image can only be acquired once.
 
-    if (ImGui::Button("Clear Log", ImVec2(200, 60))) {
-        appState.LogBuffer[0] = '\0';
+// What the render side has to do for one frame. Draw data is NULL for anything
+// unchanged since it was last rendered.
+typedef struct {
+    ImDrawData* Atlas;
+    ImDrawData* Static[PANEL_COUNT];
+} ovrPanelFrame;
+
+// Build side: queues every static panel whose content hash changed.
+static void StaticPanels_Update(ovrPanelFrame* frame) {
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        ImDrawData* drawData = &g_StaticDrawData[i];
+        if (!g_Panels[i].Static || !drawData->Valid) continue;
+
+        uint64_t hash = HashDrawData(0xCBF29CE484222325ull, drawData);
+        if (!appState.StaticHashValid[i] || hash != appState.StaticHash[i]) {
+            frame->Static[i] = drawData;
+            appState.StaticHash[i] = hash;
+            appState.StaticHashValid[i] = true;
+        }
     }
+}
 
-    ImGui::End();
+// Render side: replaces the panel's swapchain with a new static one holding drawData.
+static void StaticPanel_Render(int panelIndex, ImDrawData* drawData) {
+    ProfileScope profile(PROFILE_STAGE_STATIC_PANEL);
+    const ovrPanel* panel = &g_Panels[panelIndex];
+    ovrSwapChain* sc = &appState.StaticSwapChains[panelIndex];
 
-    // Draw cursor crosshair so user can see where they're pointing
-    ImDrawList* drawList = ImGui::GetForegroundDrawList();
-    float cx = appState.CursorX;
-    float cy = appState.CursorY;
-    ImU32 cursorColor = appState.TriggerPressed ?
-        IM_COL32(255, 100, 100, 255) : IM_COL32(100, 255, 100, 255);
+    // The runtime keeps the old image alive for as long as it still composites it
+    ovrSwapChain_Destroy(sc);
+    ovrSwapChain_Create(appState.Session, sc, panel->Width, panel->Height,
+                        XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT);
 
-    // Draw crosshair
-    drawList->AddLine(ImVec2(cx - 20, cy), ImVec2(cx + 20, cy), cursorColor, 3.0f);
-    drawList->AddLine(ImVec2(cx, cy - 20), ImVec2(cx, cy + 20), cursorColor, 3.0f);
-    drawList->AddCircle(ImVec2(cx, cy), 15.0f, cursorColor, 16, 3.0f);
+    uint32_t imageIndex;
+    XrSwapchainImageAcquireInfo acquireInfo = {XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+    OXR(xrAcquireSwapchainImage(sc->Handle, &acquireInfo, &imageIndex));
+    XrSwapchainImageWaitInfo waitImageInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+    waitImageInfo.timeout = XR_INFINITE_DURATION;
+    OXR(xrWaitSwapchainImage(sc->Handle, &waitImageInfo));
 
-    // Show cursor position for debugging
-    char cursorText[64];
-    snprintf(cursorText, sizeof(cursorText), "Cursor: %.0f, %.0f", cx, cy);
-    drawList->AddText(ImVec2(10, UI_HEIGHT - 30), IM_COL32(255, 255, 255, 200), cursorText);
+    RenderImGuiToTexture(sc->Framebuffers[imageIndex], sc->Width, sc->Height, drawData);
 
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    XrSwapchainImageReleaseInfo releaseInfo = {XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+    OXR(xrReleaseSwapchainImage(sc->Handle, &releaseInfo));
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    XrCompositionLayerQuad* layer = &appState.PanelLayers[panelIndex];
+    layer->subImage.swapchain = sc->Handle;
+    layer->subImage.imageRect.offset = {0, 0};
+    layer->subImage.imageRect.extent = {(int32_t)sc->Width, (int32_t)sc->Height};
+
+    LOGD(RENDER, "Static panel '%s' re-rendered", panel->Title);
+}
+
+static void StaticPanels_Destroy() {
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        ovrSwapChain_Destroy(&appState.StaticSwapChains[i]);
+    }
 }
 
 // ================================================================================
@@ -707,7 +4118,7 @@ static void SetupInput() {
     suggestedBindings.countSuggestedBindings = 4;
     OXR(xrSuggestInteractionProfileBindings(g_Instance, &suggestedBindings));
 
-    ALOGI("Input actions created");
+    LOGI(INPUT, "Input actions created");
 }
 
 static void AttachActionSet() {
@@ -727,16 +4138,61 @@ static void AttachActionSet() {
     spaceInfo.subactionPath = appState.RightHandPath;
     OXR(xrCreateActionSpace(appState.Session, &spaceInfo, &appState.RightAimSpace));
 
-    ALOGI("Action set attached");
+    LOGI(INPUT, "Action set attached");
+}
+
+// Intersects the aim ray with every panel quad and puts the cursor at the nearest
+// hit, in atlas coordinates.
+static void PickPanel(const XrVector3f* origin, const XrVector3f* dir) {
+    float nearestT = 100.0f;
+    appState.HoverPanel = -1;
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        const ovrPanel* panel = &g_Panels[i];
+        const XrCompositionLayerQuad* layer = &appState.PanelLayers[i];
+        if (panel->Static) continue;  // Not interactive
+
+        // Bring the ray into the panel's frame (rotate by the inverse of its yaw);
+        // the quad lies in its z = 0 plane facing +z
+        const float s = sinf(panel->Azimuth);
+        const float c = cosf(panel->Azimuth);
+        const float ox = origin->x - layer->pose.position.x;
+        const float oy = origin->y - layer->pose.position.y;
+        const float oz = origin->z - layer->pose.position.z;
+        const float localOx = ox * c + oz * s;
+        const float localOz = -ox * s + oz * c;
+        const float localDx = dir->x * c + dir->z * s;
+        const float localDz = -dir->x * s + dir->z * c;
+
+        // Ray must point into the front face
+        if (localDz > -0.001f) continue;
+        const float t = -localOz / localDz;
+        if (t <= 0.0f || t >= nearestT) continue;
+
+        const float hitX = localOx + localDx * t;
+        const float hitY = oy + dir->y * t;
+        const float u = hitX / layer->size.width + 0.5f;
+        const float v = 0.5f - hitY / layer->size.height;   // ImGui y grows downwards
+        if (u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) continue;
+
+        nearestT = t;
+        appState.HoverPanel = i;
+        appState.CursorX = panel->AtlasX + u * panel->Width;
+        appState.CursorY = panel->AtlasY + v * panel->Height;
+    }
 }
 
-static void UpdateInput(XrTime predictedTime) {
+// Early input step, right after xrWaitFrame: sync actions and read the trigger.
+// The aim pose is sampled later by LatchCursor.
+static void UpdateInput() {
+    TraceScope trace("UpdateInput", "input");
     // Sync actions
     XrActiveActionSet activeActionSet = {appState.ActionSet, XR_NULL_PATH};
     XrActionsSyncInfo syncInfo = {XR_TYPE_ACTIONS_SYNC_INFO};
     syncInfo.countActiveActionSets = 1;
     syncInfo.activeActionSets = &activeActionSet;
     OXR(xrSyncActions(appState.Session, &syncInfo));
+    appState.InputSyncTime = GetTimeNanos();
 
     // Get trigger state (use right hand)
     XrActionStateGetInfo getInfo = {XR_TYPE_ACTION_STATE_GET_INFO};
@@ -749,61 +4205,398 @@ static void UpdateInput(XrTime predictedTime) {
     bool wasPressed = appState.TriggerPressed;
     appState.TriggerPressed = triggerState.currentState > 0.5f;
     appState.TriggerJustPressed = appState.TriggerPressed && !wasPressed;
+    if (appState.TriggerPressed != wasPressed) {
+        Trace_Emit(TRACE_EVENT_INPUT, TRACE_INPUT_TRIGGER, appState.TriggerPressed, 0, 0);
+    }
+}
+
+// Deterministic aim pose for measurements without a controller: a hand below
+// the head sweeping a Lissajous figure across the controls panel.
+static bool ScriptedAimPose(XrTime time, XrPosef* pose) {
+    const double t = time * 1e-9;
+    const float yaw = 0.25f * (float)sin(2.0 * MATH_PI * 0.25 * t);
+    const float pitch = 0.06f + 0.12f * (float)sin(2.0 * MATH_PI * 0.4 * t);
+    const float sy = sinf(yaw * 0.5f), cy = cosf(yaw * 0.5f);
+    const float sx = sinf(pitch * 0.5f), cx = cosf(pitch * 0.5f);
+
+    // Yaw about Y, then pitch about X
+    pose->orientation.x = cy * sx;
+    pose->orientation.y = sy * cx;
+    pose->orientation.z = -sy * sx;
+    pose->orientation.w = cy * cx;
+    pose->position.x = 0.15f;
+    pose->position.y = -0.3f;
+    pose->position.z = -0.3f;
+    return true;
+}
+
+// Aim pose of the right hand in LOCAL space at the given time.
+static bool LocateAimPose(XrTime time, XrPosef* pose) {
+    if (appState.ScriptedPose) {
+        return ScriptedAimPose(time, pose);
+    }
 
-    // Get aim pose (right hand)
     XrSpaceLocation aimLoc = {XR_TYPE_SPACE_LOCATION};
-    OXR(xrLocateSpace(appState.RightAimSpace, appState.LocalSpace, predictedTime, &aimLoc));
+    OXR(xrLocateSpace(appState.RightAimSpace, appState.LocalSpace, time, &aimLoc));
+    if (!(aimLoc.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT)) {
+        return false;
+    }
+    *pose = aimLoc.pose;
+    return true;
+}
 
-    if (aimLoc.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
-        float px = aimLoc.pose.position.x;
-        float py = aimLoc.pose.position.y;
-        float pz = aimLoc.pose.position.z;
+static PFN_xrConvertTimeToTimespecTimeKHR g_xrConvertTimeToTimespecTimeKHR = NULL;
 
-        // Get forward direction from quaternion (Z-forward in OpenXR)
-        XrQuaternionf q = aimLoc.pose.orientation;
+// CLOCK_MONOTONIC nanoseconds for an XrTime. Without XR_KHR_convert_timespec_time
+// XrTime is taken to be monotonic nanoseconds already, which holds on Quest.
+// Copies the log counters the diagnostics panel draws. The render this causes
+// falls inside the interval and latches nothing, so a panel with nothing else
+// changing settles instead of re-rendering every frame.
+static void LatchLogCounters() {
+    const uint64_t now = GetTimeNanos();
+    if (appState.LogLatchNs != 0 && now - appState.LogLatchNs < 1000000000ull) {
+        return;
+    }
+    appState.LogLatchNs = now;
+    __atomic_store_n(&appState.LogWrittenShown, __atomic_load_n(&g_LogSink.Written, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&appState.LogDroppedShown, __atomic_load_n(&g_LogSink.Dropped, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+    for (int cat = 0; cat < LOG_CAT_COUNT; cat++) {
+        __atomic_store_n(&appState.LogSuppressedShown[cat],
+                         __atomic_load_n(&g_LogSuppressed[cat], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+}
+
+static uint64_t XrTimeToMonotonicNanos(XrTime time) {
+    struct timespec ts;
+    if (g_xrConvertTimeToTimespecTimeKHR &&
+        XR_SUCCEEDED(g_xrConvertTimeToTimespecTimeKHR(g_Instance, time, &ts))) {
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    }
+    return (uint64_t)time;
+}
+
+// Late latch: samples the aim pose for the frame's display time as late as
+// possible, immediately before ImGui consumes the cursor, and records how old
+// that sample will be when the frame reaches the display.
+static void LatchCursor(XrTime predictedDisplayTime) {
+    uint64_t latchTime = GetTimeNanos();
+
+    XrPosef pose;
+    if (LocateAimPose(predictedDisplayTime, &pose)) {
+        // Forward direction from quaternion (Z-forward in OpenXR)
+        XrQuaternionf q = pose.orientation;
 
         // Forward vector (negative Z in local space, transformed by quaternion)
         // For a quaternion q, rotating vector v: v' = q * v * q^-1
         // Simplified for unit forward vector (0, 0, -1):
-        float dx = -2.0f * (q.x * q.z - q.w * q.y);
-        float dy = -2.0f * (q.y * q.z + q.w * q.x);
-        float dz = -(1.0f - 2.0f * (q.x * q.x + q.y * q.y));
-
-        // Panel is at z = -2.0 in local space
-        float panelZ = -2.0f;
-
-        // Check if ray is pointing towards the panel (dz should be negative)
-        if (dz < -0.001f) {
-            float t = (panelZ - pz) / dz;
-            if (t > 0 && t < 100.0f) {  // Valid intersection in front of controller
-                float hitX = px + dx * t;
-                float hitY = py + dy * t;
-
-                // Panel dimensions in world space (1.6m wide, 1.2m tall, centered at origin)
-                float panelWidth = 1.6f;
-                float panelHeight = 1.2f;
-
-                // Convert world hit position to UI coordinates
-                // Panel X: -0.8 to 0.8 maps to UI 1024 to 0 (inverted)
-                // Panel Y: -0.6 to 0.6 maps to UI 0 to 768 (inverted)
-                appState.CursorX = (0.5f - (hitX / panelWidth)) * UI_WIDTH;
-                appState.CursorY = ((hitY / panelHeight) + 0.5f) * UI_HEIGHT;
-
-                // Clamp to UI bounds
-                if (appState.CursorX < 0) appState.CursorX = 0;
-                if (appState.CursorX > UI_WIDTH) appState.CursorX = UI_WIDTH;
-                if (appState.CursorY < 0) appState.CursorY = 0;
-                if (appState.CursorY > UI_HEIGHT) appState.CursorY = UI_HEIGHT;
-            }
+        XrVector3f dir;
+        dir.x = -2.0f * (q.x * q.z + q.w * q.y);
+        dir.y = -2.0f * (q.y * q.z - q.w * q.x);
+        dir.z = -(1.0f - 2.0f * (q.x * q.x + q.y * q.y));
+
+        PickPanel(&pose.position, &dir);
+    }
+
+    uint64_t displayTime = XrTimeToMonotonicNanos(predictedDisplayTime);
+    if (displayTime > latchTime) {
+        uint64_t m2pNs = displayTime - latchTime;
+        Profiler_Record(PROFILE_STAGE_CURSOR_M2P, m2pNs);
+        LOGV(INPUT, "Cursor motion-to-photon %.2f ms (latched %.2f ms after action sync)",
+              m2pNs / 1e6, (latchTime - appState.InputSyncTime) / 1e6);
+    }
+}
+
+// ================================================================================
+// Frame Submission
+// ================================================================================
+// Second half of a frame: xrBeginFrame, render whatever changed, xrEndFrame.
+// Unchanged panels re-submit their last released image without touching a
+// swapchain.
+static void SubmitFrame(const XrFrameState* frameState, const ovrPanelFrame* frame) {
+    {
+        ProfileScope profile(PROFILE_STAGE_BEGIN_FRAME);
+        XrFrameBeginInfo beginInfo = {XR_TYPE_FRAME_BEGIN_INFO};
+        OXR(xrBeginFrame(appState.Session, &beginInfo));
+    }
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        if (frame->Static[i]) {
+            StaticPanel_Render(i, frame->Static[i]);
+        }
+    }
+
+    if (frame->Atlas) {
+        // Acquire swapchain image
+        uint32_t imageIndex;
+        {
+            ProfileScope profile(PROFILE_STAGE_ACQUIRE);
+            XrSwapchainImageAcquireInfo acquireInfo = {XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+            OXR(xrAcquireSwapchainImage(appState.UiSwapChain.Handle, &acquireInfo, &imageIndex));
+        }
+        {
+            ProfileScope profile(PROFILE_STAGE_WAIT_IMAGE);
+            XrSwapchainImageWaitInfo waitImageInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+            waitImageInfo.timeout = XR_INFINITE_DURATION;
+            OXR(xrWaitSwapchainImage(appState.UiSwapChain.Handle, &waitImageInfo));
+        }
+
+        // Render ImGui to swapchain texture
+        {
+            ProfileScope profile(PROFILE_STAGE_RENDER_UI);
+            GpuTimer_Begin();
+            RenderImGuiToTexture(appState.UiSwapChain.Framebuffers[imageIndex],
+                                 appState.UiSwapChain.Width, appState.UiSwapChain.Height,
+                                 frame->Atlas);
+            GpuTimer_End();
+        }
+
+        // Release swapchain image
+        {
+            ProfileScope profile(PROFILE_STAGE_RELEASE);
+            XrSwapchainImageReleaseInfo releaseInfo = {XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+            OXR(xrReleaseSwapchainImage(appState.UiSwapChain.Handle, &releaseInfo));
+        }
+
+        // Each layer shows exactly the region its panel was rendered into
+        for (int i = 0; i < PANEL_COUNT; i++) {
+            if (g_Panels[i].Static) continue;
+            appState.PanelLayers[i].subImage.imageRect =
+                GetPanelImageRect(&g_Panels[i], frame->Atlas->FramebufferScale.x);
+        }
+        appState.UiLayerValid = true;
+        appState.PanelFramesRendered++;
+        __atomic_store_n(&appState.PanelSkippedShown, appState.PanelFramesSkipped, __ATOMIC_RELAXED);
+        LatchLogCounters();
+    } else if (frameState->shouldRender) {
+        // The compositor keeps showing the last released image
+        appState.PanelFramesSkipped++;
+    }
+
+    if (frameState->shouldRender &&
+        ((appState.PanelFramesRendered + appState.PanelFramesSkipped) % 900) == 0) {
+        LOGV(RENDER, "Panel frames: %llu rendered, %llu skipped",
+              (unsigned long long)appState.PanelFramesRendered,
+              (unsigned long long)appState.PanelFramesSkipped);
+    }
+
+    // End frame
+    // Only panels that have an image yet
+    const XrCompositionLayerBaseHeader* layers[PANEL_COUNT];
+    uint32_t layerCount = 0;
+    for (int i = 0; frameState->shouldRender && i < PANEL_COUNT; i++) {
+        bool hasImage = g_Panels[i].Static ?
+            appState.StaticSwapChains[i].Handle != XR_NULL_HANDLE : appState.UiLayerValid;
+        if (hasImage) {
+            layers[layerCount++] = (const XrCompositionLayerBaseHeader*)&appState.PanelLayers[i];
+        }
+    }
+
+    XrFrameEndInfo endInfo = {XR_TYPE_FRAME_END_INFO};
+    endInfo.displayTime = frameState->predictedDisplayTime;
+    endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+    endInfo.layerCount = layerCount;
+    endInfo.layers = layers;
+
+    ProfileScope profile(PROFILE_STAGE_END_FRAME);
+    OXR(xrEndFrame(appState.Session, &endInfo));
+}
+
+// ================================================================================
+// Render Pipeline
+// ================================================================================
+// Optional two-stage pipeline. The main thread runs xrWaitFrame, input and the
+// ImGui build for frame N+1 while the render thread, which owns the EGL context,
+// submits frame N. Frames are handed over through a bounded ring of draw-data
+// snapshots; the main thread blocks when all slots are in use.
+#define PIPELINE_DEPTH 2
+
+typedef struct {
+    bool Valid;                     // false when unchanged
+    ImDrawData DrawData;            // Points into Lists
+    ImVector<ImDrawList*> Lists;    // Owned copies, reused across frames
+} ovrDrawDataCopy;
+
+typedef struct {
+    XrFrameState FrameState;
+    ovrDrawDataCopy Atlas;
+    ovrDrawDataCopy Static[PANEL_COUNT];
+} ovrFrameSnapshot;
+
+typedef struct {
+    pthread_t Thread;
+    pthread_mutex_t Mutex;
+    pthread_cond_t Cond;
+    ovrFrameSnapshot Slots[PIPELINE_DEPTH];
+    int Head;       // Oldest queued slot, owned by the render thread while Count > 0
+    int Count;      // Queued slots, including the one being submitted
+    bool Started;
+    bool Quit;
+} ovrRenderPipeline;
+
+static ovrRenderPipeline g_Pipeline;
+
+static void ovrDrawDataCopy_Set(ovrDrawDataCopy* copy, const ImDrawData* src) {
+    copy->Valid = src != NULL;
+    if (!src) return;
+
+    while (copy->Lists.Size < src->CmdListsCount) {
+        copy->Lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    }
+
+    copy->DrawData.Clear();
+    for (int n = 0; n < src->CmdListsCount; n++) {
+        const ImDrawList* srcList = src->CmdLists[n];
+        ImDrawList* dstList = copy->Lists[n];
+        dstList->CmdBuffer = srcList->CmdBuffer;
+        dstList->IdxBuffer = srcList->IdxBuffer;
+        dstList->VtxBuffer = srcList->VtxBuffer;
+        dstList->Flags = srcList->Flags;
+        // AddDrawList checks the write cursors against the buffers
+        dstList->_VtxCurrentIdx = srcList->_VtxCurrentIdx;
+        dstList->_VtxWritePtr = dstList->VtxBuffer.Data + dstList->VtxBuffer.Size;
+        dstList->_IdxWritePtr = dstList->IdxBuffer.Data + dstList->IdxBuffer.Size;
+        copy->DrawData.AddDrawList(dstList);
+    }
+    copy->DrawData.Valid = true;
+    copy->DrawData.DisplayPos = src->DisplayPos;
+    copy->DrawData.DisplaySize = src->DisplaySize;
+    copy->DrawData.FramebufferScale = src->FramebufferScale;
+}
+
+static void ovrDrawDataCopy_Free(ovrDrawDataCopy* copy) {
+    for (int n = 0; n < copy->Lists.Size; n++) {
+        IM_DELETE(copy->Lists[n]);
+    }
+    copy->Lists.clear();
+    copy->DrawData.Clear();
+    copy->Valid = false;
+}
+
+static void* RenderThreadMain(void* arg) {
+    ovrRenderPipeline* pipeline = (ovrRenderPipeline*)arg;
+    prctl(PR_SET_NAME, (long)"XrRender", 0, 0, 0);
+
+    ovrEgl* egl = &appState.Egl;
+    eglMakeCurrent(egl->Display, egl->TinySurface, egl->TinySurface, egl->Context);
+
+    pthread_mutex_lock(&pipeline->Mutex);
+    for (;;) {
+        while (pipeline->Count == 0 && !pipeline->Quit) {
+            pthread_cond_wait(&pipeline->Cond, &pipeline->Mutex);
+        }
+        if (pipeline->Count == 0) {
+            break;  // Quit requested and everything queued has been submitted
+        }
+        ovrFrameSnapshot* snap = &pipeline->Slots[pipeline->Head];
+        pthread_mutex_unlock(&pipeline->Mutex);
+
+        ovrPanelFrame frame;
+        frame.Atlas = snap->Atlas.Valid ? &snap->Atlas.DrawData : NULL;
+        for (int i = 0; i < PANEL_COUNT; i++) {
+            frame.Static[i] = snap->Static[i].Valid ? &snap->Static[i].DrawData : NULL;
+        }
+        SubmitFrame(&snap->FrameState, &frame);
+
+        pthread_mutex_lock(&pipeline->Mutex);
+        pipeline->Head = (pipeline->Head + 1) % PIPELINE_DEPTH;
+        pipeline->Count--;
+        pthread_cond_broadcast(&pipeline->Cond);
+    }
+    pthread_mutex_unlock(&pipeline->Mutex);
+
+    eglMakeCurrent(egl->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    LOGI(RENDER, "Render thread exiting");
+    return NULL;
+}
+
+// Hands the EGL context over to a new render thread. GL resources (swapchain,
+// framebuffer, ImGui device objects) must already exist.
+static void RenderPipeline_Start(ovrRenderPipeline* pipeline) {
+    pipeline->Head = 0;
+    pipeline->Count = 0;
+    pipeline->Quit = false;
+    pthread_mutex_init(&pipeline->Mutex, NULL);
+    pthread_cond_init(&pipeline->Cond, NULL);
+
+    ovrEgl* egl = &appState.Egl;
+    eglMakeCurrent(egl->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    pthread_create(&pipeline->Thread, NULL, RenderThreadMain, pipeline);
+    pipeline->Started = true;
+    LOGI(RENDER, "Render pipeline started (%d slots)", PIPELINE_DEPTH);
+}
+
+// Stops the render thread after it has submitted everything queued and makes
+// the EGL context current on the calling thread again.
+static void RenderPipeline_Stop(ovrRenderPipeline* pipeline) {
+    if (!pipeline->Started) return;
+
+    pthread_mutex_lock(&pipeline->Mutex);
+    pipeline->Quit = true;
+    pthread_cond_broadcast(&pipeline->Cond);
+    pthread_mutex_unlock(&pipeline->Mutex);
+    pthread_join(pipeline->Thread, NULL);
+
+    for (int i = 0; i < PIPELINE_DEPTH; i++) {
+        ovrFrameSnapshot* snap = &pipeline->Slots[i];
+        ovrDrawDataCopy_Free(&snap->Atlas);
+        for (int n = 0; n < PANEL_COUNT; n++) {
+            ovrDrawDataCopy_Free(&snap->Static[n]);
         }
     }
+    pthread_cond_destroy(&pipeline->Cond);
+    pthread_mutex_destroy(&pipeline->Mutex);
+    pipeline->Started = false;
+
+    ovrEgl* egl = &appState.Egl;
+    eglMakeCurrent(egl->Display, egl->TinySurface, egl->TinySurface, egl->Context);
+}
+
+// Queues a frame for the render thread, blocking while every slot is in use.
+static void RenderPipeline_Submit(ovrRenderPipeline* pipeline, const XrFrameState* frameState,
+                                  const ovrPanelFrame* frame) {
+    pthread_mutex_lock(&pipeline->Mutex);
+    while (pipeline->Count == PIPELINE_DEPTH) {
+        pthread_cond_wait(&pipeline->Cond, &pipeline->Mutex);
+    }
+    ovrFrameSnapshot* snap = &pipeline->Slots[(pipeline->Head + pipeline->Count) % PIPELINE_DEPTH];
+    pthread_mutex_unlock(&pipeline->Mutex);
+
+    // The free slot is owned by this thread until it is published below
+    snap->FrameState = *frameState;
+    ovrDrawDataCopy_Set(&snap->Atlas, frame->Atlas);
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        ovrDrawDataCopy_Set(&snap->Static[i], frame->Static[i]);
+    }
+
+    pthread_mutex_lock(&pipeline->Mutex);
+    pipeline->Count++;
+    pthread_cond_broadcast(&pipeline->Cond);
+    pthread_mutex_unlock(&pipeline->Mutex);
+}
+
+// Blocks until the render thread has submitted every queued frame.
+static void RenderPipeline_Flush(ovrRenderPipeline* pipeline) {
+    if (!pipeline->Started) return;
+
+    pthread_mutex_lock(&pipeline->Mutex);
+    while (pipeline->Count > 0) {
+        pthread_cond_wait(&pipeline->Cond, &pipeline->Mutex);
+    }
+    pthread_mutex_unlock(&pipeline->Mutex);
 }
 
 // ================================================================================
 // Session Management
 // ================================================================================
 static void HandleSessionStateChange(XrSessionState state) {
-    ALOGI("Session state: %d", state);
+    LOGI(XR, "Session state: %d", state);
+    Trace_Emit(TRACE_EVENT_SESSION_STATE, (uint32_t)state, 0, 0, 0);
+    if ((uint32_t)state < sizeof(SESSION_STATE_NAMES) / sizeof(SESSION_STATE_NAMES[0])) {
+        Spans_Instant(SESSION_STATE_NAMES[state], "session");
+    }
 
     switch (state) {
         case XR_SESSION_STATE_READY: {
@@ -815,6 +4608,8 @@ static void HandleSessionStateChange(XrSessionState state) {
             break;
         }
         case XR_SESSION_STATE_STOPPING:
+            // No frame may still be in flight on the render thread
+            RenderPipeline_Flush(&g_Pipeline);
             OXR(xrEndSession(appState.Session));
             appState.SessionActive = false;
             AppendLog("VR Session stopped");
@@ -828,36 +4623,67 @@ static void HandleSessionStateChange(XrSessionState state) {
     }
 }
 
+#ifdef __ANDROID__
 static void HandleAppCmd(struct android_app* app, int32_t cmd) {
+    Trace_Emit(TRACE_EVENT_APP_CMD, (uint32_t)cmd, 0, 0, 0);
+    if (cmd >= 0 && cmd < (int32_t)(sizeof(APP_CMD_NAMES) / sizeof(APP_CMD_NAMES[0]))) {
+        Spans_Instant(APP_CMD_NAMES[cmd], "app");
+    }
     switch (cmd) {
         case APP_CMD_RESUME:
             appState.Resumed = true;
-            ALOGI("App resumed");
+            LOGI(APP, "App resumed");
             break;
         case APP_CMD_PAUSE:
             appState.Resumed = false;
-            ALOGI("App paused");
+            LOGI(APP, "App paused");
             break;
         case APP_CMD_DESTROY:
             appState.Running = false;
-            ALOGI("App destroyed");
+            LOGI(APP, "App destroyed");
             break;
     }
 }
+#endif
 
 // ================================================================================
 // Main Entry Point
 // ================================================================================
-void android_main(struct android_app* app) {
-    ALOGI("XrPresenceTest starting...");
+static bool IsInstanceExtensionSupported(const char* name) {
+    uint32_t count = 0;
+    OXR(xrEnumerateInstanceExtensionProperties(NULL, 0, &count, NULL));
+    XrExtensionProperties* props = (XrExtensionProperties*)calloc(count, sizeof(XrExtensionProperties));
+    for (uint32_t i = 0; i < count; i++) {
+        props[i].type = XR_TYPE_EXTENSION_PROPERTIES;
+    }
+    OXR(xrEnumerateInstanceExtensionProperties(NULL, count, &count, props));
 
-    JNIEnv* env;
-    app->activity->vm->AttachCurrentThread(&env, NULL);
-    prctl(PR_SET_NAME, (long)"XrPresence", 0, 0, 0);
+    bool supported = false;
+    for (uint32_t i = 0; i < count && !supported; i++) {
+        supported = strcmp(props[i].extensionName, name) == 0;
+    }
+    free(props);
+    return supported;
+}
+
+// Everything between platform entry and the main loop: OpenXR instance,
+// session, swapchains, input, ImGui and the Platform SDK.
+static void AppInit() {
+    g_Requests.LaunchNs = GetTimeNanos();
+    appState.AutoFlow = GetConfigInt("auto_flow", 0);
+    int logLines = GetConfigInt("log_lines", LOG_DEFAULT_LINES);
+    LogRing_Init(&g_Log, logLines > 0 ? (uint32_t)logLines : LOG_DEFAULT_LINES);
+    int spanEvents = GetConfigInt("span_events", SPAN_DEFAULT_EVENTS);
+    if (spanEvents > 0) {
+        Spans_Init((uint32_t)spanEvents);
+    }
+    int traceRecords = GetConfigInt("trace_records", TRACE_DEFAULT_RECORDS);
+    if (traceRecords > 0) {
+        Trace_Open(appState.DataPath, (uint32_t)traceRecords);
+    }
 
-    memset(&appState, 0, sizeof(appState));
-    appState.NativeApp = app;
     appState.Running = true;
+    appState.HoverPanel = -1;
     strcpy(appState.StatusText, "Ready - Set presence before inviting!");
 
     // Default toggles - all enabled (correct flow)
@@ -868,6 +4694,9 @@ void android_main(struct android_app* app) {
 
     srand((unsigned int)time(NULL));
 
+#ifdef __ANDROID__
+    struct android_app* app = appState.NativeApp;
+
     // Initialize loader
     PFN_xrInitializeLoaderKHR xrInitializeLoaderKHR = NULL;
     xrGetInstanceProcAddr(XR_NULL_HANDLE, "xrInitializeLoaderKHR",
@@ -880,32 +4709,53 @@ void android_main(struct android_app* app) {
     }
 
     // Create OpenXR instance
-    const char* extensions[] = {
+    const char* extensions[3] = {
         XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME,
         XR_KHR_ANDROID_CREATE_INSTANCE_EXTENSION_NAME,
     };
+    uint32_t extensionCount = 2;
+#else
+    // Create OpenXR instance
+    const char* extensions[3] = {
+        XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME,
+        XR_MNDX_EGL_ENABLE_EXTENSION_NAME,
+    };
+    uint32_t extensionCount = 2;
+#endif
 
+    // Optional: maps XrTime to CLOCK_MONOTONIC for cursor latency measurements
+    bool hasTimespecTime = IsInstanceExtensionSupported(XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME);
+    if (hasTimespecTime) {
+        extensions[extensionCount++] = XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME;
+    }
+
+    XrInstanceCreateInfo instanceInfo = {XR_TYPE_INSTANCE_CREATE_INFO};
+#ifdef __ANDROID__
     XrInstanceCreateInfoAndroidKHR androidInfo = {XR_TYPE_INSTANCE_CREATE_INFO_ANDROID_KHR};
     androidInfo.applicationVM = app->activity->vm;
     androidInfo.applicationActivity = app->activity->clazz;
-
-    XrInstanceCreateInfo instanceInfo = {XR_TYPE_INSTANCE_CREATE_INFO};
     instanceInfo.next = &androidInfo;
+#endif
     strcpy(instanceInfo.applicationInfo.applicationName, "XrPresenceTest");
     instanceInfo.applicationInfo.applicationVersion = 1;
     strcpy(instanceInfo.applicationInfo.engineName, "Custom");
     instanceInfo.applicationInfo.apiVersion = XR_CURRENT_API_VERSION;
-    instanceInfo.enabledExtensionCount = 2;
+    instanceInfo.enabledExtensionCount = extensionCount;
     instanceInfo.enabledExtensionNames = extensions;
 
     OXR(xrCreateInstance(&instanceInfo, &g_Instance));
-    ALOGI("OpenXR instance created");
+    LOGI(XR, "OpenXR instance created");
+
+    if (hasTimespecTime) {
+        xrGetInstanceProcAddr(g_Instance, "xrConvertTimeToTimespecTimeKHR",
+                              (PFN_xrVoidFunction*)&g_xrConvertTimeToTimespecTimeKHR);
+    }
 
     // Get system
     XrSystemGetInfo systemInfo = {XR_TYPE_SYSTEM_GET_INFO};
     systemInfo.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
     OXR(xrGetSystem(g_Instance, &systemInfo, &appState.SystemId));
-    ALOGI("System ID: %lu", (unsigned long)appState.SystemId);
+    LOGI(XR, "System ID: %lu", (unsigned long)appState.SystemId);
 
     // Initialize EGL
     ovrEgl_CreateContext(&appState.Egl);
@@ -918,7 +4768,12 @@ void android_main(struct android_app* app) {
     xrGetOpenGLESGraphicsRequirementsKHR(g_Instance, appState.SystemId, &graphicsReqs);
 
     // Create session
+#ifdef __ANDROID__
     XrGraphicsBindingOpenGLESAndroidKHR graphicsBinding = {XR_TYPE_GRAPHICS_BINDING_OPENGL_ES_ANDROID_KHR};
+#else
+    XrGraphicsBindingEGLMNDX graphicsBinding = {XR_TYPE_GRAPHICS_BINDING_EGL_MNDX};
+    graphicsBinding.getProcAddress = (PFN_xrEglGetProcAddressMNDX)eglGetProcAddress;
+#endif
     graphicsBinding.display = appState.Egl.Display;
     graphicsBinding.config = appState.Egl.Config;
     graphicsBinding.context = appState.Egl.Context;
@@ -927,7 +4782,7 @@ void android_main(struct android_app* app) {
     sessionInfo.next = &graphicsBinding;
     sessionInfo.systemId = appState.SystemId;
     OXR(xrCreateSession(g_Instance, &sessionInfo, &appState.Session));
-    ALOGI("Session created");
+    LOGI(XR, "Session created");
 
     // Create reference spaces
     XrReferenceSpaceCreateInfo spaceInfo = {XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
@@ -938,23 +4793,33 @@ void android_main(struct android_app* app) {
     spaceInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
     OXR(xrCreateReferenceSpace(appState.Session, &spaceInfo, &appState.HeadSpace));
 
-    // Create UI swapchain
-    ovrSwapChain_Create(appState.Session, &appState.UiSwapChain, UI_WIDTH, UI_HEIGHT);
-
-    // Create framebuffer for UI rendering
-    glGenFramebuffers(1, &appState.UiFramebuffer);
+    // Pack the panels into one atlas swapchain (with one framebuffer per image)
+    // and build their quad layers once; they are re-submitted every frame
+    Atlas_Pack();
+    ovrSwapChain_Create(appState.Session, &appState.UiSwapChain, g_Atlas.Width, g_Atlas.Height, 0);
+    Atlas_InitLayers();
 
     // Setup input
     SetupInput();
+    appState.ScriptedPose = GetConfigInt("scripted_pose", 0) != 0;
+    if (appState.ScriptedPose) {
+        LOGI(INPUT, "Using scripted aim pose");
+    }
 
     // Initialize ImGui
     InitImGui();
 
-    // Attach actions after session is ready
-    bool actionsAttached = false;
+    // Adaptive panel resolution, measured with GPU timer queries where available
+    GpuTimer_Init();
+    appState.AdaptiveResolution = GetConfigInt("adaptive_res", 1) != 0;
 
-    app->userData = &appState;
-    app->onAppCmd = HandleAppCmd;
+    // Optionally move GL submission to a render thread. Device objects are
+    // created up front because the main thread gives up the EGL context.
+    appState.Pipelined = GetConfigInt("pipelined", 0) != 0;
+    if (appState.Pipelined) {
+        ImGui_ImplOpenGL3_CreateDeviceObjects();
+        RenderPipeline_Start(&g_Pipeline);
+    }
 
     AppendLog("XrPresenceTest initialized!");
     AppendLog("App ID: %s", APP_ID);
@@ -963,31 +4828,95 @@ void android_main(struct android_app* app) {
 
     // Initialize Oculus Platform SDK
     AppendLog("Initializing Platform SDK...");
-    ALOGI("Platform SDK init with APP_ID: %s", APP_ID);
+    RegisterPlatformHandlers();
+    int invitableCache = GetConfigInt("invitable_cache", INVITABLE_DEFAULT_CAPACITY);
+    Invitable_Init(invitableCache > 0 ? (uint32_t)invitableCache : INVITABLE_DEFAULT_CAPACITY);
+    int inviteBatch = GetConfigInt("invite_batch", INVITE_DEFAULT_BATCH);
+    int inviteInFlight = GetConfigInt("invite_in_flight", INVITE_DEFAULT_IN_FLIGHT);
+    InviteSender_Init(inviteBatch > 0 ? (uint32_t)inviteBatch : INVITE_DEFAULT_BATCH,
+                      inviteInFlight > 0 ? inviteInFlight : INVITE_DEFAULT_IN_FLIGHT,
+                      GetConfigInt("invite_rate", INVITE_DEFAULT_RATE));
+    if (GetConfigInt("record_platform", 0) != 0) {
+        Recorder_Open(appState.DataPath ? appState.DataPath : ".");
+    }
+    PlatformPump_Start(&g_PlatformPump, GetConfigInt("platform_thread", 0) != 0,
+                       (uint32_t)GetConfigInt("platform_queue", PLATFORM_QUEUE_DEFAULT_EVENTS),
+                       GetConfigInt("platform_budget", PLATFORM_BUDGET_DEFAULT_EVENTS),
+                       GetConfigInt("platform_budget_us", PLATFORM_BUDGET_DEFAULT_US));
+    LOGI(PLATFORM, "Platform SDK init with APP_ID: %s", APP_ID);
     AppendLog("Using APP_ID: %s", APP_ID);
-    ovrRequest initRequest = ovr_PlatformInitializeAndroidAsynchronous(APP_ID, app->activity->clazz, env);
-    ALOGI("Platform SDK init request: %llu", (unsigned long long)initRequest);
+#ifdef __ANDROID__
+    ovrRequest initRequest = ovr_PlatformInitializeAndroidAsynchronous(APP_ID, app->activity->clazz, appState.Env);
+    TrackPlatformRequest(ovrMessage_PlatformInitializeAndroidAsynchronous, initRequest);
+#else
+    ovrPlatformInitializeResult initResult = ovrPlatformInitialize_Success;
+    ovrRequest initRequest = ovr_PlatformInitializeWindowsAsynchronous(APP_ID, &initResult);
+    TrackPlatformRequest(ovrMessage_PlatformInitializeWindowsAsynchronous, initRequest);
+#endif
+    LOGI(PLATFORM, "Platform SDK init request: %llu", (unsigned long long)initRequest);
 
     AppendLog("Point controller at buttons");
     AppendLog("Pull trigger to click");
+}
+
+#ifdef __ANDROID__
+// Dispatches looper events, blocking up to timeoutMs (-1 = forever) for the first.
+static void HostPumpEvents(int timeoutMs) {
+    struct android_app* app = appState.NativeApp;
+    int events;
+    struct android_poll_source* source;
+
+    while (ALooper_pollOnce(timeoutMs, NULL, &events, (void**)&source) >= 0) {
+        if (source) {
+            source->process(app, source);
+        }
+        if (app->destroyRequested) {
+            appState.Running = false;
+            break;
+        }
+        timeoutMs = 0;
+    }
+}
+#else
+// Headless build: there is no event source, so a blocking pump just sleeps.
+// The run ends after the benchmark duration or on SIGINT.
+static volatile sig_atomic_t g_HostStopRequested = 0;
+static uint64_t g_HostDeadlineNs = 0;
+
+static void HostPumpEvents(int timeoutMs) {
+    if (timeoutMs != 0) {
+        usleep((timeoutMs > 0 ? timeoutMs : IDLE_TIMEOUT_MS) * 1000);
+    }
+    if (g_HostStopRequested || (g_HostDeadlineNs != 0 && GetTimeNanos() >= g_HostDeadlineNs)) {
+        appState.Running = false;
+    }
+}
+#endif
 
-    // Main loop
+static void RunMainLoop() {
     while (appState.Running) {
-        // Process Android events
-        int events;
-        struct android_poll_source* source;
-        int timeout = (!appState.Resumed && !appState.SessionActive) ? -1 : 0;
-
-        while (ALooper_pollOnce(timeout, NULL, &events, (void**)&source) >= 0) {
-            if (source) {
-                source->process(app, source);
-            }
-            if (app->destroyRequested) {
-                appState.Running = false;
-                break;
-            }
-            timeout = 0;
+        TraceScope frameTrace("Frame", "frame");
+        uint64_t frameStart = GetTimeNanos();
+        Recorder_BeginFrame(frameStart);
+
+        // Resumed without a running session (e.g. while a system panel such as
+        // the invite panel has focus) the loop has no xrWaitFrame to pace it, so
+        // block on the looper instead of spinning. The Platform SDK cannot wake
+        // the looper, so poll it at a bounded interval, and briefly much faster
+        // after traffic since responses tend to arrive in bursts.
+        bool idle = appState.Resumed && !appState.SessionActive;
+        int timeout = 0;
+        if (!appState.Resumed && !appState.SessionActive) {
+            timeout = -1;
+        } else if (idle) {
+            timeout = (frameStart - appState.LastPlatformMessageTime < IDLE_BURST_NS) ?
+                IDLE_BURST_TIMEOUT_MS : IDLE_TIMEOUT_MS;
         }
+        bool blocking = timeout != 0;
+        uint64_t idleCpuStart = idle ? GetThreadCpuNanos() : 0;
+
+        // Process Android (looper) events
+        HostPumpEvents(timeout);
 
         // Process OpenXR events
         XrEventDataBuffer event = {XR_TYPE_EVENT_DATA_BUFFER};
@@ -998,94 +4927,108 @@ void android_main(struct android_app* app) {
                         (XrEventDataSessionStateChanged*)&event;
                     HandleSessionStateChange(stateEvent->state);
 
-                    if (stateEvent->state == XR_SESSION_STATE_READY && !actionsAttached) {
+                    // Attach actions after session is ready
+                    if (stateEvent->state == XR_SESSION_STATE_READY && !appState.ActionsAttached) {
                         AttachActionSet();
-                        actionsAttached = true;
+                        appState.ActionsAttached = true;
                     }
                     break;
                 }
                 case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING:
                     appState.Running = false;
                     break;
+                default:
+                    break;
             }
             event = {XR_TYPE_EVENT_DATA_BUFFER};
         }
 
+        // Time spent blocked on a paused app is not event processing
+        if (!blocking) {
+            Profiler_Record(PROFILE_STAGE_EVENTS, GetTimeNanos() - frameStart);
+        }
+
         // Process Oculus Platform SDK messages (async responses)
-        ProcessPlatformMessages();
+        {
+            ProfileScope profile(PROFILE_STAGE_PLATFORM);
+            if (ProcessPlatformMessages() > 0) {
+                appState.LastPlatformMessageTime = GetTimeNanos();
+            }
+        }
+
+        if (idle) {
+            uint64_t cpuNs = GetThreadCpuNanos() - idleCpuStart;
+            uint64_t wallNs = GetTimeNanos() - frameStart;
+            Profiler_Record(PROFILE_STAGE_IDLE_CPU, cpuNs);
+            g_Profiler.IdleWallNs += wallNs;
+            g_Profiler.IdleCpuNs += cpuNs;
+            appState.IdlePeriodWallNs += wallNs;
+            appState.IdlePeriodCpuNs += cpuNs;
+        } else if (appState.IdlePeriodWallNs > 0) {
+            LOGI(APP, "Idle for %.1f s, main thread CPU %.2f%%", appState.IdlePeriodWallNs / 1e9,
+                  100.0 * (double)appState.IdlePeriodCpuNs / (double)appState.IdlePeriodWallNs);
+            appState.IdlePeriodWallNs = 0;
+            appState.IdlePeriodCpuNs = 0;
+        }
 
         if (!appState.SessionActive) {
             continue;
         }
-
         // Wait for frame
         XrFrameState frameState = {XR_TYPE_FRAME_STATE};
         XrFrameWaitInfo waitInfo = {XR_TYPE_FRAME_WAIT_INFO};
+        uint64_t waitStart = GetTimeNanos();
         OXR(xrWaitFrame(appState.Session, &waitInfo, &frameState));
-
-        // Begin frame
-        XrFrameBeginInfo beginInfo = {XR_TYPE_FRAME_BEGIN_INFO};
-        OXR(xrBeginFrame(appState.Session, &beginInfo));
+        uint64_t waitNs = GetTimeNanos() - waitStart;
+        Profiler_Record(PROFILE_STAGE_WAIT_FRAME, waitNs);
 
         // Update input
-        UpdateInput(frameState.predictedDisplayTime);
-
-        // Acquire swapchain image
-        uint32_t imageIndex;
-        XrSwapchainImageAcquireInfo acquireInfo = {XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
-        OXR(xrAcquireSwapchainImage(appState.UiSwapChain.Handle, &acquireInfo, &imageIndex));
+        {
+            ProfileScope profile(PROFILE_STAGE_INPUT);
+            UpdateInput();
+        }
 
-        XrSwapchainImageWaitInfo waitImageInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
-        waitImageInfo.timeout = XR_INFINITE_DURATION;
-        OXR(xrWaitSwapchainImage(appState.UiSwapChain.Handle, &waitImageInfo));
+        // Build the UI every frame so input is processed, but only hand draw
+        // data to the renderer when the panel would actually look different.
+        ovrPanelFrame panelFrame = {};
+        {
+            ProfileScope profile(PROFILE_STAGE_BUILD_UI);
+            LatchCursor(frameState.predictedDisplayTime);
+            ImDrawData* drawData = BuildImGuiFrame();
+            if (frameState.shouldRender && drawData) {
+                uint64_t panelHash = HashPanelFrame(drawData);
+                if (!appState.PanelHashValid || panelHash != appState.LastPanelHash) {
+                    panelFrame.Atlas = drawData;
+                }
+                appState.LastPanelHash = panelHash;
+                appState.PanelHashValid = true;
+                StaticPanels_Update(&panelFrame);
+            }
+        }
 
-        // Render ImGui to swapchain texture
-        RenderImGuiToTexture(appState.UiSwapChain.ColorTextures[imageIndex]);
+        if (appState.Pipelined) {
+            RenderPipeline_Submit(&g_Pipeline, &frameState, &panelFrame);
+        } else {
+            SubmitFrame(&frameState, &panelFrame);
+        }
 
-        // Release swapchain image
-        XrSwapchainImageReleaseInfo releaseInfo = {XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
-        OXR(xrReleaseSwapchainImage(appState.UiSwapChain.Handle, &releaseInfo));
-
-        // Build quad layer for UI
-        XrCompositionLayerQuad quadLayer = {XR_TYPE_COMPOSITION_LAYER_QUAD};
-        quadLayer.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
-        quadLayer.space = appState.LocalSpace;
-        quadLayer.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
-        quadLayer.subImage.swapchain = appState.UiSwapChain.Handle;
-        quadLayer.subImage.imageRect.offset = {0, 0};
-        quadLayer.subImage.imageRect.extent = {(int)UI_WIDTH, (int)UI_HEIGHT};
-        quadLayer.subImage.imageArrayIndex = 0;
-
-        // Position the quad in front of user
-        quadLayer.pose.orientation.w = 1.0f;
-        quadLayer.pose.position.x = 0.0f;
-        quadLayer.pose.position.y = 0.0f;
-        quadLayer.pose.position.z = -2.0f;
-        quadLayer.size.width = 1.6f;
-        quadLayer.size.height = 1.2f;
-
-        // End frame
-        const XrCompositionLayerBaseHeader* layers[] = {
-            (XrCompositionLayerBaseHeader*)&quadLayer
-        };
-
-        XrFrameEndInfo endInfo = {XR_TYPE_FRAME_END_INFO};
-        endInfo.displayTime = frameState.predictedDisplayTime;
-        endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
-        endInfo.layerCount = frameState.shouldRender ? 1 : 0;
-        endInfo.layers = layers;
-
-        OXR(xrEndFrame(appState.Session, &endInfo));
+        uint64_t frameNs = GetTimeNanos() - frameStart;
+        Profiler_Record(PROFILE_STAGE_FRAME, frameNs);
+        AdaptivePanel_Update(frameNs - waitNs, frameState.predictedDisplayPeriod);
     }
+}
 
-    // Cleanup
+static void AppShutdown() {
+    RequestAwaits_CancelAll();
+    PlatformPump_Stop(&g_PlatformPump);
+    Invitable_Destroy();
+    Recorder_Close();
+    RenderPipeline_Stop(&g_Pipeline);
+    GpuTimer_Shutdown();
     ShutdownImGui();
 
-    if (appState.UiFramebuffer) {
-        glDeleteFramebuffers(1, &appState.UiFramebuffer);
-    }
-
     ovrSwapChain_Destroy(&appState.UiSwapChain);
+    StaticPanels_Destroy();
 
     if (appState.LeftAimSpace) xrDestroySpace(appState.LeftAimSpace);
     if (appState.RightAimSpace) xrDestroySpace(appState.RightAimSpace);
@@ -1095,8 +5038,142 @@ void android_main(struct android_app* app) {
     if (g_Instance) xrDestroyInstance(g_Instance);
 
     ovrEgl_DestroyContext(&appState.Egl);
+    Trace_Close();
+    LogRing_Destroy(&g_Log);
+}
+
+#ifdef __ANDROID__
+void android_main(struct android_app* app) {
+    LoadLogLevels();
+    LogSink_Start(&g_LogSink, (uint32_t)GetConfigInt("log_queue", LOG_SINK_DEFAULT_RECORDS));
+    LOGI(APP, "XrPresenceTest starting...");
+
+    JNIEnv* env;
+    app->activity->vm->AttachCurrentThread(&env, NULL);
+    prctl(PR_SET_NAME, (long)"XrPresence", 0, 0, 0);
+
+    memset(&appState, 0, sizeof(appState));
+    appState.NativeApp = app;
+    appState.Env = env;
+    appState.DataPath = app->activity->externalDataPath ?
+        app->activity->externalDataPath : app->activity->internalDataPath;
+
+    AppInit();
+
+    app->userData = &appState;
+    app->onAppCmd = HandleAppCmd;
+
+    RunMainLoop();
+
+    // Cleanup
+    AppShutdown();
 
     app->activity->vm->DetachCurrentThread();
 
-    ALOGI("XrPresenceTest shutdown complete");
+    LOGI(APP, "XrPresenceTest shutdown complete");
+    LogSink_Stop(&g_LogSink);
+}
+#else
+static void HandleSigint(int) {
+    g_HostStopRequested = 1;
+}
+
+// Stage percentiles over the last PROFILE_RING_SIZE samples, plus run totals.
+static void PrintBenchmarkSummary(uint64_t runNs) {
+    Profiler_UpdateStats();
+    printf("\n%-12s %8s %9s %9s %9s\n", "stage", "samples", "p50 ms", "p95 ms", "p99 ms");
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        if (g_Profiler.Count[stage] == 0) continue;
+        printf("%-12s %8u %9.3f %9.3f %9.3f\n", PROFILE_STAGE_NAMES[stage], g_Profiler.Count[stage],
+               g_Profiler.P50[stage], g_Profiler.P95[stage], g_Profiler.P99[stage]);
+    }
+
+    double seconds = runNs / 1e9;
+    uint32_t frames = g_Profiler.Count[PROFILE_STAGE_WAIT_FRAME];
+    printf("\nrun %.2f s, %u frames (%.1f fps), panel renders %llu, skipped %llu\n",
+           seconds, frames, frames / seconds,
+           (unsigned long long)appState.PanelFramesRendered,
+           (unsigned long long)appState.PanelFramesSkipped);
+    printf("platform messages %llu (%.1f msg/s)\n",
+           (unsigned long long)appState.PlatformMessagesHandled,
+           appState.PlatformMessagesHandled / seconds);
+    int order[MESSAGE_TYPE_COUNT];
+    int types = GetBusiestMessageTypes(order);
+    for (int i = 0; i < types && i < 5; i++) {
+        const ovrMessageRoute* route = &g_MessageRoutes[order[i]];
+        printf("  %-48s %8llu (%llu errors)\n", MESSAGE_TYPE_NAMES[order[i]],
+               (unsigned long long)route->Received, (unsigned long long)route->Errors);
+    }
+    for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+        const ovrRequestStats* stats = &g_Requests.Stats[i];
+        if (stats->Issued == 0) continue;
+        printf("request %-40s %llu ok, %llu failed, %u never completed, p50 %.1f ms, max %.1f ms\n",
+               MESSAGE_TYPE_NAMES[i], (unsigned long long)stats->Succeeded, (unsigned long long)stats->Failed,
+               stats->Pending, RequestStats_Percentile(stats, 50), stats->MaxNs / 1e6);
+    }
+    printf("platform pump %s, max backlog %llu, budget-limited frames %llu, max handoff %.2f ms, ring full %llu\n",
+           g_PlatformPump.Running ? "thread" : "inline", (unsigned long long)g_PlatformPump.MaxBacklog,
+           (unsigned long long)g_PlatformPump.LimitedFrames, g_PlatformPump.MaxHandoffNs / 1e6,
+           (unsigned long long)__atomic_load_n(&g_PlatformPump.FullPolls, __ATOMIC_RELAXED));
+    if (g_Presence.Updates > 0) {
+        printf("presence updates %llu, sent %llu, superseded %llu, unchanged %llu\n",
+               (unsigned long long)g_Presence.Updates, (unsigned long long)g_Presence.Sent,
+               (unsigned long long)g_Presence.Superseded, (unsigned long long)g_Presence.Unchanged);
+    }
+    if (g_Invitable.Pages > 0) {
+        printf("invitable users %u in %u pages (%u duplicates, %u dropped), first page %.1f ms, slowest %.1f ms\n",
+               g_Invitable.Count, g_Invitable.Pages, g_Invitable.Duplicates, g_Invitable.Dropped,
+               g_Invitable.FirstPageNs / 1e6, g_Invitable.MaxPageNs / 1e6);
+    }
+    if (g_InviteSender.Ids.Size > 0) {
+        printf("invites %u/%d sent (%u reported), %u failed, %llu retries, %.1f users/s, slowest batch %.1f ms\n",
+               g_InviteSender.UsersSent, g_InviteSender.Ids.Size, g_InviteSender.InvitesReported,
+               g_InviteSender.UsersFailed, (unsigned long long)g_InviteSender.Retries, InviteSender_Throughput(),
+               g_InviteSender.MaxBatchNs / 1e6);
+    }
+    if (g_Requests.LastTimeToJoinableNs > 0) {
+        printf("time to joinable %.1f ms, launch to joinable %.2f s\n",
+               g_Requests.LastTimeToJoinableNs / 1e6, g_Requests.LaunchToJoinableNs / 1e9);
+    }
+    if (g_Profiler.IdleWallNs > 0) {
+        printf("idle %.2f s at %.2f%% of a core\n", g_Profiler.IdleWallNs / 1e9,
+               100.0 * (double)g_Profiler.IdleCpuNs / (double)g_Profiler.IdleWallNs);
+    }
+}
+
+// Headless benchmark entry point, run against the stub OpenXR runtime and
+// Platform SDK from Projects/Linux. Tuned through XRPRESENCE_* variables.
+int main() {
+    LoadLogLevels();
+    LogSink_Start(&g_LogSink, (uint32_t)GetConfigInt("log_queue", LOG_SINK_DEFAULT_RECORDS));
+    LOGI(APP, "XrPresenceTest (headless) starting...");
+    prctl(PR_SET_NAME, (long)"XrPresence", 0, 0, 0);
+    signal(SIGINT, HandleSigint);
+
+    memset(&appState, 0, sizeof(appState));
+    const char* dataDir = getenv("XRPRESENCE_DATA_DIR");
+    appState.DataPath = dataDir ? dataDir : ".";
+    appState.Resumed = true;    // No activity lifecycle
+
+    AppInit();
+
+    uint64_t runStart = GetTimeNanos();
+    int seconds = GetConfigInt("bench_seconds", 10);
+    g_HostDeadlineNs = seconds > 0 ? runStart + (uint64_t)seconds * 1000000000ull : 0;
+
+    RunMainLoop();
+
+    RenderPipeline_Flush(&g_Pipeline);
+    PrintBenchmarkSummary(GetTimeNanos() - runStart);
+    Profiler_DumpCsv();
+    RequestTracker_DumpCsv();
+    Spans_ExportJson();
+
+    // Cleanup
+    AppShutdown();
+
+    LOGI(APP, "XrPresenceTest shutdown complete");
+    LogSink_Stop(&g_LogSink);
+    return 0;
 }
+#endif
@@ -0,0 +1,134 @@
+// Generated by Tools/gen_message_types.py from the Platform SDK headers. Do not edit.
+//
+// OVR_MESSAGE(name, payload): ovrMessage_<name>, whose payload is read with
+// ovr_Message_Get<payload>(), or None when the message carries no payload.
+
+OVR_MESSAGE(AbuseReport_ReportRequestHandled, None)
+OVR_MESSAGE(Achievements_AddCount, AchievementUpdate)
+OVR_MESSAGE(Achievements_AddFields, AchievementUpdate)
+OVR_MESSAGE(Achievements_GetAllDefinitions, AchievementDefinitionArray)
+OVR_MESSAGE(Achievements_GetAllProgress, AchievementProgressArray)
+OVR_MESSAGE(Achievements_GetDefinitionsByName, AchievementDefinitionArray)
+OVR_MESSAGE(Achievements_GetNextAchievementDefinitionArrayPage, AchievementDefinitionArray)
+OVR_MESSAGE(Achievements_GetNextAchievementProgressArrayPage, AchievementProgressArray)
+OVR_MESSAGE(Achievements_GetProgressByName, AchievementProgressArray)
+OVR_MESSAGE(Achievements_Unlock, AchievementUpdate)
+OVR_MESSAGE(ApplicationLifecycle_GetRegisteredPIDs, PidArray)
+OVR_MESSAGE(ApplicationLifecycle_GetSessionKey, String)
+OVR_MESSAGE(ApplicationLifecycle_RegisterSessionKey, None)
+OVR_MESSAGE(Application_CancelAppDownload, AppDownloadResult)
+OVR_MESSAGE(Application_CheckAppDownloadProgress, AppDownloadProgressResult)
+OVR_MESSAGE(Application_GetVersion, ApplicationVersion)
+OVR_MESSAGE(Application_InstallAppUpdateAndRelaunch, AppDownloadResult)
+OVR_MESSAGE(Application_LaunchOtherApp, String)
+OVR_MESSAGE(Application_StartAppDownload, AppDownloadResult)
+OVR_MESSAGE(AssetFile_Delete, AssetFileDeleteResult)
+OVR_MESSAGE(AssetFile_DeleteById, AssetFileDeleteResult)
+OVR_MESSAGE(AssetFile_DeleteByName, AssetFileDeleteResult)
+OVR_MESSAGE(AssetFile_Download, AssetFileDownloadResult)
+OVR_MESSAGE(AssetFile_DownloadById, AssetFileDownloadResult)
+OVR_MESSAGE(AssetFile_DownloadByName, AssetFileDownloadResult)
+OVR_MESSAGE(AssetFile_DownloadCancel, AssetFileDownloadCancelResult)
+OVR_MESSAGE(AssetFile_DownloadCancelById, AssetFileDownloadCancelResult)
+OVR_MESSAGE(AssetFile_DownloadCancelByName, AssetFileDownloadCancelResult)
+OVR_MESSAGE(AssetFile_GetList, AssetDetailsArray)
+OVR_MESSAGE(AssetFile_Status, AssetDetails)
+OVR_MESSAGE(AssetFile_StatusById, AssetDetails)
+OVR_MESSAGE(AssetFile_StatusByName, AssetDetails)
+OVR_MESSAGE(Avatar_LaunchAvatarEditor, AvatarEditorResult)
+OVR_MESSAGE(Challenges_Create, Challenge)
+OVR_MESSAGE(Challenges_DeclineInvite, Challenge)
+OVR_MESSAGE(Challenges_Delete, None)
+OVR_MESSAGE(Challenges_Get, Challenge)
+OVR_MESSAGE(Challenges_GetEntries, ChallengeEntryArray)
+OVR_MESSAGE(Challenges_GetEntriesAfterRank, ChallengeEntryArray)
+OVR_MESSAGE(Challenges_GetEntriesByIds, ChallengeEntryArray)
+OVR_MESSAGE(Challenges_GetList, ChallengeArray)
+OVR_MESSAGE(Challenges_GetNextChallenges, ChallengeArray)
+OVR_MESSAGE(Challenges_GetNextEntries, ChallengeEntryArray)
+OVR_MESSAGE(Challenges_GetPreviousChallenges, ChallengeArray)
+OVR_MESSAGE(Challenges_GetPreviousEntries, ChallengeEntryArray)
+OVR_MESSAGE(Challenges_Join, Challenge)
+OVR_MESSAGE(Challenges_Leave, Challenge)
+OVR_MESSAGE(Challenges_UpdateInfo, Challenge)
+OVR_MESSAGE(DeviceApplicationIntegrity_GetIntegrityToken, String)
+OVR_MESSAGE(Entitlement_GetIsViewerEntitled, None)
+OVR_MESSAGE(GroupPresence_Clear, None)
+OVR_MESSAGE(GroupPresence_GetInvitableUsers, UserArray)
+OVR_MESSAGE(GroupPresence_GetNextApplicationInviteArrayPage, ApplicationInviteArray)
+OVR_MESSAGE(GroupPresence_GetSentInvites, ApplicationInviteArray)
+OVR_MESSAGE(GroupPresence_LaunchInvitePanel, InvitePanelResultInfo)
+OVR_MESSAGE(GroupPresence_LaunchMultiplayerErrorDialog, None)
+OVR_MESSAGE(GroupPresence_LaunchRejoinDialog, RejoinDialogResult)
+OVR_MESSAGE(GroupPresence_LaunchRosterPanel, None)
+OVR_MESSAGE(GroupPresence_SendInvites, SendInvitesResult)
+OVR_MESSAGE(GroupPresence_Set, None)
+OVR_MESSAGE(GroupPresence_SetDeeplinkMessageOverride, None)
+OVR_MESSAGE(GroupPresence_SetDestination, None)
+OVR_MESSAGE(GroupPresence_SetIsJoinable, None)
+OVR_MESSAGE(GroupPresence_SetLobbySession, None)
+OVR_MESSAGE(GroupPresence_SetMatchSession, None)
+OVR_MESSAGE(IAP_ConsumePurchase, None)
+OVR_MESSAGE(IAP_GetNextProductArrayPage, ProductArray)
+OVR_MESSAGE(IAP_GetNextPurchaseArrayPage, PurchaseArray)
+OVR_MESSAGE(IAP_GetProductsBySKU, ProductArray)
+OVR_MESSAGE(IAP_GetViewerPurchases, PurchaseArray)
+OVR_MESSAGE(IAP_GetViewerPurchasesDurableCache, PurchaseArray)
+OVR_MESSAGE(IAP_LaunchCheckoutFlow, Purchase)
+OVR_MESSAGE(LanguagePack_GetCurrent, AssetDetails)
+OVR_MESSAGE(LanguagePack_SetCurrent, AssetFileDownloadResult)
+OVR_MESSAGE(Leaderboard_Get, LeaderboardArray)
+OVR_MESSAGE(Leaderboard_GetEntries, LeaderboardEntryArray)
+OVR_MESSAGE(Leaderboard_GetEntriesAfterRank, LeaderboardEntryArray)
+OVR_MESSAGE(Leaderboard_GetEntriesByIds, LeaderboardEntryArray)
+OVR_MESSAGE(Leaderboard_GetNextEntries, LeaderboardEntryArray)
+OVR_MESSAGE(Leaderboard_GetNextLeaderboardArrayPage, LeaderboardArray)
+OVR_MESSAGE(Leaderboard_GetPreviousEntries, LeaderboardEntryArray)
+OVR_MESSAGE(Leaderboard_WriteEntry, LeaderboardUpdateStatus)
+OVR_MESSAGE(Leaderboard_WriteEntryWithSupplementaryMetric, LeaderboardUpdateStatus)
+OVR_MESSAGE(Media_ShareToFacebook, ShareMediaResult)
+OVR_MESSAGE(Notification_MarkAsRead, None)
+OVR_MESSAGE(PushNotification_Register, PushNotificationResult)
+OVR_MESSAGE(RichPresence_Clear, None)
+OVR_MESSAGE(RichPresence_GetDestinations, DestinationArray)
+OVR_MESSAGE(RichPresence_GetNextDestinationArrayPage, DestinationArray)
+OVR_MESSAGE(RichPresence_Set, None)
+OVR_MESSAGE(UserAgeCategory_Get, UserAccountAgeCategory)
+OVR_MESSAGE(UserAgeCategory_Report, None)
+OVR_MESSAGE(User_Get, User)
+OVR_MESSAGE(User_GetAccessToken, String)
+OVR_MESSAGE(User_GetBlockedUsers, BlockedUserArray)
+OVR_MESSAGE(User_GetLinkedAccounts, LinkedAccountArray)
+OVR_MESSAGE(User_GetLoggedInUser, User)
+OVR_MESSAGE(User_GetLoggedInUserFriends, UserArray)
+OVR_MESSAGE(User_GetLoggedInUserManagedInfo, User)
+OVR_MESSAGE(User_GetNextBlockedUserArrayPage, BlockedUserArray)
+OVR_MESSAGE(User_GetNextUserArrayPage, UserArray)
+OVR_MESSAGE(User_GetNextUserCapabilityArrayPage, UserCapabilityArray)
+OVR_MESSAGE(User_GetOrgScopedID, OrgScopedID)
+OVR_MESSAGE(User_GetSdkAccounts, SdkAccountArray)
+OVR_MESSAGE(User_GetUserProof, UserProof)
+OVR_MESSAGE(User_LaunchBlockFlow, LaunchBlockFlowResult)
+OVR_MESSAGE(User_LaunchFriendRequestFlow, LaunchFriendRequestFlowResult)
+OVR_MESSAGE(User_LaunchUnblockFlow, LaunchUnblockFlowResult)
+OVR_MESSAGE(Voip_GetMicrophoneAvailability, MicrophoneAvailabilityState)
+OVR_MESSAGE(Voip_SetSystemVoipSuppressed, SystemVoipState)
+OVR_MESSAGE(Notification_AbuseReport_ReportButtonPressed, String)
+OVR_MESSAGE(Notification_ApplicationLifecycle_LaunchIntentChanged, String)
+OVR_MESSAGE(Notification_AssetFile_DownloadUpdate, AssetFileDownloadUpdate)
+OVR_MESSAGE(Notification_GroupPresence_InvitationsSent, LaunchInvitePanelFlowResult)
+OVR_MESSAGE(Notification_GroupPresence_JoinIntentReceived, GroupPresenceJoinIntent)
+OVR_MESSAGE(Notification_GroupPresence_LeaveIntentReceived, GroupPresenceLeaveIntent)
+OVR_MESSAGE(Notification_HTTP_Transfer, HttpTransferUpdate)
+OVR_MESSAGE(Notification_Livestreaming_StatusChange, LivestreamingStatus)
+OVR_MESSAGE(Notification_NetSync_ConnectionStatusChanged, NetSyncConnection)
+OVR_MESSAGE(Notification_NetSync_SessionsChanged, NetSyncSessionsChangedNotification)
+OVR_MESSAGE(Notification_Party_PartyUpdate, PartyUpdateNotification)
+OVR_MESSAGE(Notification_Voip_MicrophoneAvailabilityStateUpdate, String)
+OVR_MESSAGE(Notification_Voip_SystemVoipState, SystemVoipState)
+OVR_MESSAGE(Notification_Vrcamera_GetDataChannelMessageUpdate, String)
+OVR_MESSAGE(Notification_Vrcamera_GetSurfaceUpdate, String)
+OVR_MESSAGE(PlatformInitializeWithAccessToken, None)
+OVR_MESSAGE(Platform_InitializeStandaloneOculus, None)
+OVR_MESSAGE(PlatformInitializeAndroidAsynchronous, None)
+OVR_MESSAGE(PlatformInitializeWindowsAsynchronous, None)
@@ -0,0 +1,61 @@
+/*
+ * XrPresenceTest Platform message recording format, written by the app and
+ * replayed by the headless build's stub Platform SDK (OVRSTUB_REPLAY).
+ *
+ * The file is a fixed header followed by a stream of fields, each a
+ * ovrRecordingField tag and length and then that many bytes, unpadded. A
+ * message starts with a RECORDING_TAG_MESSAGE field holding an
+ * ovrRecordedMessage; the optional fields after it, up to the next message,
+ * carry its error text and the payload values the app reads. Readers skip
+ * tags they do not know.
+ */
+
+#ifndef XR_RECORDING_FORMAT_H
+#define XR_RECORDING_FORMAT_H
+
+#include <stdint.h>
+
+#define RECORDING_MAGIC "XRMSGREC"     // 8 bytes, no terminator
+#define RECORDING_VERSION 1
+
+typedef struct {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t HeaderSize;
+    uint64_t StartRealtimeNs;   // CLOCK_REALTIME when recording started
+    uint64_t Reserved;
+} ovrRecordingHeader;
+
+typedef struct {
+    uint16_t Tag;               // ovrRecordingTag
+    uint16_t Length;            // Bytes that follow
+} ovrRecordingField;
+
+typedef enum {
+    RECORDING_TAG_MESSAGE = 1,          // ovrRecordedMessage
+    RECORDING_TAG_ERROR_MESSAGE = 2,    // Text
+    RECORDING_TAG_DEEPLINK_MESSAGE = 3, // Text, join intent
+    RECORDING_TAG_DESTINATION = 4,      // Text, join and leave intents
+    RECORDING_TAG_LOBBY_SESSION = 5,    // Text, join and leave intents
+    RECORDING_TAG_MATCH_SESSION = 6,    // Text, join and leave intents
+    RECORDING_TAG_INVITED_USERS = 7,    // uint32_t, users invited
+    RECORDING_TAG_INVITES_SENT = 8,     // uint8_t, invite panel result
+} ovrRecordingTag;
+
+typedef struct {
+    uint64_t TimeNs;            // Popped, since recording started
+    uint64_t RequestId;         // ovrRequest, 0 for notifications
+    uint32_t Type;              // ovrMessageType
+    int32_t ErrorCode;
+    uint32_t Flags;
+    uint32_t Frame;             // Frame the message arrived in
+    uint32_t FrameOffsetUs;     // Popped, since that frame started
+    uint32_t Reserved;
+} ovrRecordedMessage;
+
+#define RECORDING_FLAG_ERROR 0x1     // Error response
+
+static_assert(sizeof(ovrRecordingHeader) == 32, "recording header layout");
+static_assert(sizeof(ovrRecordedMessage) == 40, "recorded message layout");
+
+#endif // XR_RECORDING_FORMAT_H
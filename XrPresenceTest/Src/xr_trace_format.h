@@ -0,0 +1,65 @@
+/*
+ * XrPresenceTest event trace file format, shared by the app and Tools/xrtrace.
+ *
+ * The file is a fixed header followed by a power-of-two ring of fixed-size
+ * records. The app maps it MAP_SHARED and appends with plain stores, so the
+ * trace is in the page cache (and ends up on disk) even if the process dies.
+ *
+ * Record i (counting from 0 since the file was created) lives in slot
+ * i & (Capacity - 1). Its Sequence is the low 32 bits of i + 1 and is stored
+ * last with release ordering: a reader only trusts a slot whose Sequence
+ * matches the index it expects, which rejects both stale and torn records.
+ */
+
+#ifndef XR_TRACE_FORMAT_H
+#define XR_TRACE_FORMAT_H
+
+#include <stdint.h>
+
+#define TRACE_MAGIC "XRTRACE"     // 8 bytes with the terminator
+#define TRACE_VERSION 1
+#define TRACE_FILE_NAME "xrpresence.trace"
+#define TRACE_PREV_FILE_NAME "xrpresence.prev.trace"  // Previous run, kept for post-mortems
+
+typedef struct {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t HeaderSize;
+    uint32_t RecordSize;
+    uint32_t Capacity;          // Records in the ring, a power of two
+    uint64_t StartTimeNs;       // CLOCK_MONOTONIC when the trace was created
+    uint64_t StartRealtimeNs;   // CLOCK_REALTIME at the same moment, for wall-clock output
+    uint64_t WritePos;          // Records claimed so far; atomic
+    uint32_t Pid;
+    uint32_t Reserved[3];
+} ovrTraceHeader;
+
+typedef enum {
+    TRACE_EVENT_APP_START = 1,          // Value: pid
+    TRACE_EVENT_SESSION_STATE = 2,      // Arg: XrSessionState
+    TRACE_EVENT_APP_CMD = 3,            // Arg: android_native_app_glue APP_CMD_*
+    TRACE_EVENT_PLATFORM_REQUEST = 4,   // Arg: ovrMessageType of the response, Id: ovrRequest
+    TRACE_EVENT_PLATFORM_RESPONSE = 5,  // Arg: ovrMessageType, Id: ovrRequest, Value: error code
+    TRACE_EVENT_INPUT = 6,              // Arg: ovrTraceInput, Value: 1 pressed / 0 released
+} ovrTraceEvent;
+
+typedef enum {
+    TRACE_INPUT_TRIGGER = 0,
+} ovrTraceInput;
+
+#define TRACE_FLAG_ERROR 0x1     // Platform response is an error
+
+typedef struct {
+    uint64_t TimeNs;        // CLOCK_MONOTONIC
+    uint64_t Id;            // ovrRequest, 0 when unused
+    uint32_t Arg;
+    int32_t Value;
+    uint16_t Event;         // ovrTraceEvent
+    uint16_t Flags;
+    uint32_t Sequence;      // Low 32 bits of record index + 1, written last
+} ovrTraceRecord;
+
+static_assert(sizeof(ovrTraceHeader) == 64, "trace header layout");
+static_assert(sizeof(ovrTraceRecord) == 32, "trace record layout");
+
+#endif // XR_TRACE_FORMAT_H
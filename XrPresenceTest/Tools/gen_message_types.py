@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Regenerates Src/ovr_message_types.h from the Platform SDK headers.
+
+Every ovrMessageType in OVR_MessageType.h becomes one X-macro entry with the
+ovr_Message_Get<Payload>() accessor its documentation names, or None when the
+response has no payload. Run after updating third_party/ovr_platform_sdk:
+
+    python3 Tools/gen_message_types.py
+"""
+
+import os
+import re
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+INCLUDE = os.path.join(ROOT, "third_party", "ovr_platform_sdk", "Include")
+OUTPUT = os.path.join(ROOT, "Src", "ovr_message_types.h")
+
+TYPE_RE = re.compile(r"^\s*ovrMessage_(\w+)\s*=\s*0x[0-9A-Fa-f]+")
+PAYLOAD_RE = re.compile(r"Extract the payload from the message handle with ::ovr_Message_Get(\w+)\(\)")
+RESPONSE_RE = re.compile(r"A message with type ::ovrMessage_(\w+) will be generated in response")
+
+
+def main():
+    payloads = {}
+
+    # Notifications document their payload right above the enum value
+    types = []
+    comment = []
+    with open(os.path.join(INCLUDE, "OVR_MessageType.h")) as f:
+        for line in f:
+            if line.strip().startswith("///"):
+                comment.append(line)
+                continue
+            match = TYPE_RE.match(line)
+            if match:
+                types.append(match.group(1))
+                payload = PAYLOAD_RE.search("".join(comment) + line)
+                if payload:
+                    payloads[match.group(1)] = payload.group(1)
+            comment = []
+
+    # Request responses are documented with the request function
+    for name in sorted(os.listdir(INCLUDE)):
+        if not name.startswith("OVR_Requests_") and not name.startswith("OVR_Functions_"):
+            continue
+        with open(os.path.join(INCLUDE, name)) as f:
+            for block in f.read().split("OVRP_PUBLIC_FUNCTION"):
+                response = RESPONSE_RE.search(block)
+                payload = PAYLOAD_RE.search(block)
+                if response and payload:
+                    payloads.setdefault(response.group(1), payload.group(1))
+
+    with open(OUTPUT, "w") as out:
+        out.write("// Generated by Tools/gen_message_types.py from the Platform SDK headers. Do not edit.\n")
+        out.write("//\n")
+        out.write("// OVR_MESSAGE(name, payload): ovrMessage_<name>, whose payload is read with\n")
+        out.write("// ovr_Message_Get<payload>(), or None when the message carries no payload.\n\n")
+        for message in types:
+            out.write("OVR_MESSAGE(%s, %s)\n" % (message, payloads.get(message, "None")))
+    print("%s: %d message types, %d with payloads" % (OUTPUT, len(types), sum(t in payloads for t in types)))
+
+
+if __name__ == "__main__":
+    main()
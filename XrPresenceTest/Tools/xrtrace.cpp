@@ -0,0 +1,269 @@
+/*
+ * xrtrace - prints and filters an XrPresenceTest event trace.
+ *
+ * Pull the trace off the headset with
+ *   adb pull /sdcard/Android/data/<package>/files/xrpresence.trace
+ * (xrpresence.prev.trace is the run before, e.g. the one that crashed).
+ *
+ * Usage: xrtrace [options] <trace file>
+ *   -e <event>   Only this event: start, session, cmd, request, response, input.
+ *                May be repeated.
+ *   -r <id>      Only records for this ovrRequest ID
+ *   -m <type>    Only this Platform message type (name below or hex)
+ *   -n <count>   Only the last <count> matching records
+ *   -w           Wall-clock timestamps instead of seconds since trace start
+ *   -s           Summary only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
+
+#include <OVR_MessageType.h>
+
+#include "xr_trace_format.h"
+
+static const char* const EVENT_NAMES[] = {
+    NULL, "start", "session", "cmd", "request", "response", "input",
+};
+static const int EVENT_NAME_COUNT = sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]);
+
+static const char* const SESSION_STATE_NAMES[] = {
+    "UNKNOWN", "IDLE", "READY", "SYNCHRONIZED", "VISIBLE", "FOCUSED", "STOPPING", "LOSS_PENDING", "EXITING",
+};
+
+// android_native_app_glue APP_CMD_* in enum order
+static const char* const APP_CMD_NAMES[] = {
+    "INPUT_CHANGED", "INIT_WINDOW", "TERM_WINDOW", "WINDOW_RESIZED", "WINDOW_REDRAW_NEEDED",
+    "CONTENT_RECT_CHANGED", "GAINED_FOCUS", "LOST_FOCUS", "CONFIG_CHANGED", "LOW_MEMORY",
+    "START", "RESUME", "SAVE_STATE", "PAUSE", "STOP", "DESTROY",
+};
+
+static const char* const INPUT_NAMES[] = {"trigger"};
+
+// Every type the SDK defines, from the app's generated list
+static const struct {
+    const char* Name;
+    ovrMessageType Type;
+} MESSAGE_NAMES[] = {
+#define OVR_MESSAGE(name, payload) {#name, ovrMessage_##name},
+#include "ovr_message_types.h"
+#undef OVR_MESSAGE
+};
+static const int MESSAGE_NAME_COUNT = sizeof(MESSAGE_NAMES) / sizeof(MESSAGE_NAMES[0]);
+
+#define NAME_OR(table, index, fallback) \
+    ((index) < sizeof(table) / sizeof(table[0]) ? table[index] : (fallback))
+
+static const char* MessageName(uint32_t type, char* buffer, size_t size) {
+    for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+        if ((uint32_t)MESSAGE_NAMES[i].Type == type) return MESSAGE_NAMES[i].Name;
+    }
+    snprintf(buffer, size, "0x%08X", type);
+    return buffer;
+}
+
+static bool ParseMessageType(const char* token, uint32_t* type) {
+    for (int i = 0; i < MESSAGE_NAME_COUNT; i++) {
+        if (strcmp(token, MESSAGE_NAMES[i].Name) == 0) {
+            *type = (uint32_t)MESSAGE_NAMES[i].Type;
+            return true;
+        }
+    }
+    char* end = NULL;
+    unsigned long value = strtoul(token, &end, 16);
+    if (end == token || *end != '\0') return false;
+    *type = (uint32_t)value;
+    return true;
+}
+
+static void Usage() {
+    fprintf(stderr,
+            "usage: xrtrace [-e event]... [-r request] [-m type] [-n count] [-w] [-s] <trace file>\n"
+            "  events: start session cmd request response input\n");
+    exit(2);
+}
+
+typedef struct {
+    unsigned EventMask;     // Bit per ovrTraceEvent, 0 = all
+    uint64_t Request;       // 0 = all
+    uint32_t MessageType;
+    bool HasMessageType;
+    long Last;              // 0 = all
+    bool WallClock;
+    bool SummaryOnly;
+} Options;
+
+static bool Matches(const Options* options, const ovrTraceRecord* record) {
+    if (options->EventMask && !(options->EventMask & (1u << record->Event))) return false;
+    if (options->Request && record->Id != options->Request) return false;
+    if (options->HasMessageType) {
+        bool platform = record->Event == TRACE_EVENT_PLATFORM_REQUEST ||
+                        record->Event == TRACE_EVENT_PLATFORM_RESPONSE;
+        if (!platform || record->Arg != options->MessageType) return false;
+    }
+    return true;
+}
+
+static void PrintTime(const Options* options, const ovrTraceHeader* header, uint64_t timeNs) {
+    if (!options->WallClock) {
+        printf("%14.6f", (double)(int64_t)(timeNs - header->StartTimeNs) / 1e9);
+        return;
+    }
+    uint64_t wallNs = header->StartRealtimeNs + (timeNs - header->StartTimeNs);
+    time_t seconds = (time_t)(wallNs / 1000000000ull);
+    struct tm tm;
+    localtime_r(&seconds, &tm);
+    char text[32];
+    strftime(text, sizeof(text), "%Y.%m.%d-%H.%M.%S", &tm);
+    printf("%s.%06llu", text, (unsigned long long)(wallNs % 1000000000ull / 1000));
+}
+
+// requestTimes maps ovrRequest -> request time, for response latency.
+static void PrintRecord(const Options* options, const ovrTraceHeader* header, const ovrTraceRecord* record,
+                        const std::map<uint64_t, uint64_t>& requestTimes) {
+    char buffer[16];
+    PrintTime(options, header, record->TimeNs);
+    printf("  %-9s ", NAME_OR(EVENT_NAMES, record->Event, "?"));
+    switch (record->Event) {
+        case TRACE_EVENT_APP_START:
+            printf("pid %d", record->Value);
+            break;
+        case TRACE_EVENT_SESSION_STATE:
+            printf("%s", NAME_OR(SESSION_STATE_NAMES, record->Arg, "?"));
+            break;
+        case TRACE_EVENT_APP_CMD:
+            printf("APP_CMD_%s", NAME_OR(APP_CMD_NAMES, record->Arg, "?"));
+            break;
+        case TRACE_EVENT_PLATFORM_REQUEST:
+            printf("%-40s req %llu", MessageName(record->Arg, buffer, sizeof(buffer)),
+                   (unsigned long long)record->Id);
+            break;
+        case TRACE_EVENT_PLATFORM_RESPONSE: {
+            printf("%-40s req %llu", MessageName(record->Arg, buffer, sizeof(buffer)),
+                   (unsigned long long)record->Id);
+            if (record->Flags & TRACE_FLAG_ERROR) {
+                printf("  ERROR %d", record->Value);
+            }
+            auto it = record->Id ? requestTimes.find(record->Id) : requestTimes.end();
+            if (it != requestTimes.end()) {
+                printf("  %.3f ms", (double)(record->TimeNs - it->second) / 1e6);
+            }
+            break;
+        }
+        case TRACE_EVENT_INPUT:
+            printf("%s %s", NAME_OR(INPUT_NAMES, record->Arg, "?"), record->Value ? "pressed" : "released");
+            break;
+        default:
+            printf("event %u arg %u value %d id %llu", record->Event, record->Arg, record->Value,
+                   (unsigned long long)record->Id);
+            break;
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    Options options = {};
+    int opt;
+    while ((opt = getopt(argc, argv, "e:r:m:n:ws")) != -1) {
+        switch (opt) {
+            case 'e': {
+                int event = 1;
+                while (event < EVENT_NAME_COUNT && strcmp(optarg, EVENT_NAMES[event]) != 0) event++;
+                if (event == EVENT_NAME_COUNT) Usage();
+                options.EventMask |= 1u << event;
+                break;
+            }
+            case 'r':
+                options.Request = strtoull(optarg, NULL, 10);
+                break;
+            case 'm':
+                if (!ParseMessageType(optarg, &options.MessageType)) Usage();
+                options.HasMessageType = true;
+                break;
+            case 'n':
+                options.Last = atol(optarg);
+                break;
+            case 'w':
+                options.WallClock = true;
+                break;
+            case 's':
+                options.SummaryOnly = true;
+                break;
+            default:
+                Usage();
+        }
+    }
+    if (optind != argc - 1) Usage();
+
+    const char* path = argv[optind];
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "xrtrace: cannot open %s\n", path);
+        return 1;
+    }
+    ovrTraceHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(header.Magic, TRACE_MAGIC, sizeof(header.Magic)) != 0) {
+        fprintf(stderr, "xrtrace: %s is not a trace file\n", path);
+        return 1;
+    }
+    if (header.Version != TRACE_VERSION || header.RecordSize != sizeof(ovrTraceRecord) ||
+        header.Capacity == 0 || (header.Capacity & (header.Capacity - 1)) != 0) {
+        fprintf(stderr, "xrtrace: unsupported trace version %u (record size %u, capacity %u)\n",
+                header.Version, header.RecordSize, header.Capacity);
+        return 1;
+    }
+    std::vector<ovrTraceRecord> ring(header.Capacity);
+    fseek(f, header.HeaderSize, SEEK_SET);
+    size_t slots = fread(ring.data(), sizeof(ovrTraceRecord), header.Capacity, f);
+    fclose(f);
+
+    // Oldest to newest, skipping slots that were never written or torn by a crash
+    uint64_t end = header.WritePos;
+    uint64_t begin = end > header.Capacity ? end - header.Capacity : 0;
+    uint64_t torn = 0;
+    std::vector<ovrTraceRecord> records;
+    for (uint64_t index = begin; index < end; index++) {
+        uint64_t slot = index & (header.Capacity - 1);
+        if (slot >= slots || ring[slot].Sequence != (uint32_t)(index + 1)) {
+            torn++;
+            continue;
+        }
+        records.push_back(ring[slot]);
+    }
+
+    std::map<uint64_t, uint64_t> requestTimes;
+    std::vector<const ovrTraceRecord*> matches;
+    uint64_t eventCounts[EVENT_NAME_COUNT] = {};
+    uint64_t errors = 0;
+    for (const ovrTraceRecord& record : records) {
+        if (record.Event == TRACE_EVENT_PLATFORM_REQUEST) {
+            requestTimes[record.Id] = record.TimeNs;
+        }
+        if (!Matches(&options, &record)) continue;
+        matches.push_back(&record);
+        if (record.Event < EVENT_NAME_COUNT) eventCounts[record.Event]++;
+        if (record.Flags & TRACE_FLAG_ERROR) errors++;
+    }
+
+    if (!options.SummaryOnly) {
+        size_t first = options.Last > 0 && (size_t)options.Last < matches.size() ? matches.size() - options.Last : 0;
+        for (size_t i = first; i < matches.size(); i++) {
+            PrintRecord(&options, &header, matches[i], requestTimes);
+        }
+        printf("\n");
+    }
+
+    printf("%s: pid %u, %llu records written, %zu kept, %llu overwritten, %llu torn\n", path, header.Pid,
+           (unsigned long long)end, records.size(), (unsigned long long)begin, (unsigned long long)torn);
+    printf("matching %zu:", matches.size());
+    for (int event = 1; event < EVENT_NAME_COUNT; event++) {
+        if (eventCounts[event]) printf(" %s %llu", EVENT_NAMES[event], (unsigned long long)eventCounts[event]);
+    }
+    printf(", platform errors %llu\n", (unsigned long long)errors);
+    return 0;
+}